@@ -1,6 +1,7 @@
 #ifndef AST_HPP_
 #define AST_HPP_
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -25,13 +26,21 @@ struct AstNode {
     // The number of one node's sons. Should be calculated at 'appendSons()'.
     size_t sonCnt;
 
+    // Unit rules (one symbol on the right) collapsed into this node instead
+    // of given a node each, by Grammar::gen() with unit collapsing on: each
+    // rule's index plus one, the outermost in the low bits; 0 if none.
+    uint64_t rulePath;
+    static constexpr unsigned rulePathBits = 16;
+    static constexpr uint64_t rulePathMask = (1 << rulePathBits) - 1;
+
     AstNode()
         : sym(Terminal{Token{"", TokenType::NIL}}),
           parent(nullptr),
           brother(nullptr),
           son(nullptr),
           lastBrother(nullptr),
-          sonCnt(0) {}
+          sonCnt(0),
+          rulePath(0) {}
 
     // When a node is created with a sym that makes sense, it has no parent,
     // brother or son, but the "lastBrother" is just itself.
@@ -42,7 +51,8 @@ struct AstNode {
           brother(_brother),
           son(_son),
           lastBrother(this),
-          sonCnt(0) {
+          sonCnt(0),
+          rulePath(0) {
         // this->display();
     }
 
@@ -56,7 +66,8 @@ struct AstNode {
           brother(std::move(other.brother)),
           son(std::move(other.son)),
           lastBrother(other.lastBrother),
-          sonCnt(other.sonCnt) {
+          sonCnt(other.sonCnt),
+          rulePath(other.rulePath) {
         other.parent = other.brother = other.son = other.lastBrother = nullptr;
     }
 
@@ -84,6 +95,7 @@ struct AstNode {
             this->son = other.son;
             this->lastBrother = other.lastBrother;
             this->sonCnt = other.sonCnt;
+            this->rulePath = other.rulePath;
             other.brother = other.son = other.lastBrother = nullptr;
         }
         return *this;
@@ -105,6 +117,12 @@ struct AstNode {
         return;
     }
 
+    // Whether another rule fits in the rule path.
+    bool canCollapse() const { return (this->rulePath >> (64 - rulePathBits)) == 0; }
+
+    // Records that `rule`, a unit rule, was reduced onto this node.
+    void collapse(size_t rule) { this->rulePath = this->rulePath << rulePathBits | (rule + 1); }
+
     // 这个应该没什么用……
     void createNewSon(const Sym &sym) {
         AstNode *newSon = new AstNode(sym);
@@ -0,0 +1,86 @@
+#ifndef COMPRESSED_PARSE_TABLE_H_
+#define COMPRESSED_PARSE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ParseTable.h"
+
+namespace pluma {
+
+/**
+ * @brief A ParseTable packed by row displacement.
+ * The significant cells of every ACTION row are overlaid into one comb vector
+ * at a per-state offset, with a check array recording which state owns each
+ * slot; GOTO columns are packed the same way per nonterminal. Error cells and
+ * the cells of a state's most common reduction (its default reduction) are
+ * not stored, so a lookup that misses the comb falls back to the default.
+ * Every lookup is one indexed load and one compare.
+ * Default reductions may reduce where the dense table has an error; the error
+ * is still caught before the next token is shifted.
+ */
+class CompressedParseTable {
+   public:
+    using Word = ParseTable::Word;
+    using Kind = ParseTable::Kind;
+
+   private:
+    size_t beginState = 0;
+
+    // actionNext[actionBase[state] + terminalId] is the state's action if
+    // actionCheck at the same index is the state.
+    std::vector<uint32_t> actionBase;
+    std::vector<Word> actionNext;
+    std::vector<Word> actionCheck;
+
+    // Taken when the lookahead has no action: the state's NIL action if it
+    // has one, else its default reduction, else an error.
+    std::vector<Word> fallback;
+
+    // gotoNext[gotoBase[nonterminal] + state], checked against the
+    // nonterminal; most common target of each nonterminal as the default.
+    std::vector<uint32_t> gotoBase;
+    std::vector<Word> gotoNext;
+    std::vector<Word> gotoCheck;
+    std::vector<Word> gotoDefault;
+
+    std::vector<Word> lhs;
+    std::vector<Word> lengths;
+
+   public:
+    CompressedParseTable() = default;
+    explicit CompressedParseTable(const ParseTable &table);
+
+    size_t states() const { return this->fallback.size(); }
+    size_t startState() const { return this->beginState; }
+
+    // The action stored for `type`; ERROR if the state has none for it.
+    Word action(size_t state, TokenType type) const {
+        size_t i = this->actionBase[state] + ParseTable::terminalId(type);
+        if (this->actionCheck[i] != state) {
+            return ParseTable::pack(Kind::ERROR, 0);
+        }
+        return this->actionNext[i];
+    }
+
+    Word epsilonAction(size_t state) const { return this->fallback[state]; }
+
+    Word gotoState(size_t state, size_t nonterminal) const {
+        size_t i = this->gotoBase[nonterminal] + state;
+        if (this->gotoCheck[i] != nonterminal) {
+            return this->gotoDefault[nonterminal];
+        }
+        return this->gotoNext[i];
+    }
+
+    size_t ruleLhs(size_t rule) const { return this->lhs[rule]; }
+    size_t ruleLength(size_t rule) const { return this->lengths[rule]; }
+
+    // Bytes held by the arrays.
+    size_t memoryUsage() const;
+};
+
+}  // namespace pluma
+
+#endif
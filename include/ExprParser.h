@@ -0,0 +1,87 @@
+#ifndef EXPR_PARSER_H_
+#define EXPR_PARSER_H_
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+
+#include "Ast.hpp"
+#include "ParseTable.h"
+#include "TokenStream.h"
+
+namespace pluma {
+
+/**
+ * @brief Precedence climbing over C-style expressions, for Grammar::gen() to
+ * hand `expr` positions to instead of reducing a chain of nonterminals per
+ * operand.
+ * Operators and operands come from a Table; brackets, calls, member access
+ * and `?:` have their C syntax. The tree is flat: a "binary-expr" node of
+ * (operand, operator, operand) per binary or assignment operator, operands
+ * as bare terminals, and "unary-expr", "postfix-expr", "primary-expr",
+ * "func-call" and "actual-params" nodes only where an operand spans several
+ * tokens, with the tokens as sons in source order.
+ * It gives up on syntax it does not cover (casts, sizeof) and on `( id )`
+ * and `( id *`, which the C grammar reads as casts.
+ */
+class ExprParser {
+   public:
+    struct Operator {
+        int level;
+        bool rightAssociative;
+    };
+
+    struct Table {
+        // The nonterminal the parser stands in for.
+        std::string nonterminal;
+        // Binary and assignment operators; higher levels bind tighter.
+        std::map<TokenType, Operator> binary;
+        // Level of `?:`, which groups to the right.
+        int conditionalLevel;
+        std::set<TokenType> prefix;
+        std::set<TokenType> operands;
+    };
+
+   private:
+    std::string entry;
+    // By terminal id; 0 if the token is not a binary operator.
+    std::array<int, ParseTable::terminalCount> levels{};
+    std::array<bool, ParseTable::terminalCount> rightAssociative{};
+    std::array<bool, ParseTable::terminalCount> prefix{};
+    std::array<bool, ParseTable::terminalCount> operands{};
+    int conditionalLevel;
+
+    // Copied into the nodes, so no name is built per node.
+    Nonterminal binaryExpr{"binary-expr"};
+    Nonterminal conditionalExpr{"expr"};
+    Nonterminal unaryExpr{"unary-expr"};
+    Nonterminal postfixExpr{"postfix-expr"};
+    Nonterminal primaryExpr{"primary-expr"};
+    Nonterminal funcCall{"func-call"};
+    Nonterminal actualParams{"actual-params"};
+
+   public:
+    explicit ExprParser(const Table &table);
+
+    const std::string &nonterminal() const { return this->entry; }
+
+    // Whether an expression may start with `type`.
+    bool startsExpression(TokenType type) const;
+
+    // Parses the longest expression at `pos` and moves `pos` past it.
+    // Returns nullptr, with `pos` unchanged, if it gave up.
+    AstNode *parse(const TokenStream &tokens, size_t &pos) const;
+
+   private:
+    AstNode *parseExpr(const TokenStream &tokens, size_t &pos, int minLevel) const;
+    AstNode *parseUnary(const TokenStream &tokens, size_t &pos) const;
+    AstNode *parsePostfix(const TokenStream &tokens, size_t &pos) const;
+    AstNode *parsePrimary(const TokenStream &tokens, size_t &pos) const;
+    AstNode *parseCall(const TokenStream &tokens, size_t &pos) const;
+};
+
+}  // namespace pluma
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef FIRST_FOLLOW_H_
+#define FIRST_FOLLOW_H_
+
+#include <bitset>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "ParseTable.h"
+#include "Symbol.hpp"
+
+namespace pluma {
+
+// A set of terminals, by ParseTable::terminalId().
+using TerminalBits = std::bitset<ParseTable::terminalCount>;
+
+/**
+ * @brief Nullable, FIRST and FOLLOW of a grammar, as bitsets over dense
+ * symbol ids.
+ * FIRST and FOLLOW are each the least solution of F(x) = F'(x) | F(y) for
+ * every y that x is related to. Rather than sweeping the rules until nothing
+ * changes, each relation is solved in a single traversal of its graph, one
+ * strongly connected component at a time (the digraph algorithm of DeRemer
+ * and Pennello). Nullable is found in one pass as well, by counting down the
+ * symbols of each rule that are not yet known to be nullable.
+ * The terminal NIL stands for the empty string: it is nullable, and the NIL
+ * bit of a FIRST set marks a nullable nonterminal or rule suffix.
+ */
+class FirstFollow {
+   public:
+    static constexpr size_t nilId = ParseTable::terminalId(TokenType::NIL);
+
+   private:
+    // Nonterminal ids, in order of first appearance in the rules.
+    std::map<Nonterminal, size_t> ids;
+    std::vector<Nonterminal> names;
+
+    std::vector<bool> nullable;
+    std::vector<TerminalBits> firstSets;
+    std::vector<TerminalBits> followSets;
+    // FIRST of every rule's right side from every position on.
+    std::vector<std::vector<TerminalBits>> suffixFirstSets;
+
+   public:
+    FirstFollow() = default;
+    // The left side of rules[0] is the start symbol; TK_EOF follows it.
+    explicit FirstFollow(const std::vector<Rule> &rules);
+
+    size_t nonterminals() const { return this->names.size(); }
+    const Nonterminal &nonterminal(size_t id) const { return this->names[id]; }
+
+    bool isNullable(size_t id) const { return this->nullable[id]; }
+    const TerminalBits &first(size_t id) const { return this->firstSets[id]; }
+    const TerminalBits &follow(size_t id) const { return this->followSets[id]; }
+
+    // FIRST of the right side of `rule` from `pos` on; NIL if that suffix
+    // derives the empty string, as the empty suffix at the end does.
+    const TerminalBits &suffixFirst(size_t rule, size_t pos) const {
+        return this->suffixFirstSets[rule][pos];
+    }
+};
+
+}  // namespace pluma
+
+#endif
@@ -2,8 +2,10 @@
 #define FORMATTER_H_
 
 #include <fstream>
+#include <vector>
 
 #include "Ast.hpp"
+#include "TokenStream.h"
 
 namespace pluma {
 
@@ -12,6 +14,11 @@ struct Formatter {
     std::ofstream out;
     static constexpr size_t indentSize = 4;
 
+    // Stream the AST's tokens came from; source of their text and comments.
+    const TokenStream *tokens = nullptr;
+    // Rules of the grammar the AST was parsed by, which rule paths index.
+    const std::vector<Rule> *rules = nullptr;
+
    private:
     void formatNode(const AstNode *, const size_t indents);
     void printIndents(const size_t indents);
@@ -23,7 +30,7 @@ struct Formatter {
 
    public:
     Formatter(std::string filename);
-    void format(const Ast &);
+    void format(const Ast &, const TokenStream &, const std::vector<Rule> &);
     ~Formatter();
 };
 
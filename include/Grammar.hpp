@@ -7,15 +7,20 @@
 #include <iostream>
 #include <map>
 #include <set>
+#include <span>
 #include <string>
 #include <utility>
 #include <variant>
 #include <vector>
 
 #include "Ast.hpp"
+#include "CompressedParseTable.h"
+#include "ExprParser.h"
+#include "FirstFollow.h"
 #include "Logger.h"
+#include "ParseTable.h"
+#include "TokenStream.h"
 #include "main.h"
-#include "utils/Hash.h"
 
 namespace pluma {
 
@@ -35,60 +40,96 @@ struct Action {
     bool operator<(const Action &rhs) const;
 };
 
+// The LR(1) items of a state that share a core (a rule and a dot position),
+// with their lookaheads merged into one set.
 struct LR1_Item {
-    // 文法的产生式
-    Rule rule;
+    // 产生式在文法中的下标
+    uint32_t ruleIndex;
 
     // 项的点的位置
     // 例: A -> ·aBb , currPos == 0
     //     A -> a·Bb , currPos == 1
     //     A -> aBb· , currPos == 3
-    size_t currPos;
+    uint32_t currPos;
 
-    Terminal lookahead;
+    TerminalBits lookaheads;
+
+    uint64_t core() const { return (uint64_t)this->ruleIndex << 32 | this->currPos; }
+
+    // Orders items by core only; a set holds one item per core.
+    bool operator<(const LR1_Item &rhs) const { return this->core() < rhs.core(); }
+};
+
+// The items of a state, sorted by core.
+using ItemSet = std::vector<LR1_Item>;
+
+// How a table cell with more than one action is settled, the way yacc does.
+// A rule takes the precedence of its last terminal that has one, unless it
+// names another terminal in `rules`. A shift/reduce conflict between a rule
+// and a lookahead that both have a precedence goes to the higher one; at
+// equal precedence LEFT reduces, RIGHT shifts and NONASSOC leaves an error.
+// Any other shift/reduce conflict shifts, and a reduce/reduce conflict
+// reduces by the lowest rule.
+struct ConflictPolicy {
+    enum class Associativity {
+        LEFT,
+        RIGHT,
+        NONASSOC,
+    };
+
+    struct Precedence {
+        int level;
+        Associativity associativity;
+    };
+
+    std::map<TokenType, Precedence> terminals;
+    // Rule index -> the terminal whose precedence the rule takes.
+    std::map<size_t, TokenType> rules;
+};
 
-    bool operator<(const LR1_Item &rhs) const {
-        if (this->rule.first == rhs.rule.first) {
-            if (this->rule.second == rhs.rule.second) {
-                if (this->currPos == rhs.currPos) {
-                    return this->lookahead < rhs.lookahead;
-                } else {
-                    return this->currPos < rhs.currPos;
-                }
-            } else {
-                return this->rule.second < rhs.rule.second;
-            }
-        }
-        return this->rule.first < rhs.rule.first;
-    }
-    bool operator==(const LR1_Item &rhs) const {
-        return this->rule == rhs.rule && this->currPos == rhs.currPos &&
-               this->lookahead == rhs.lookahead;
-    }
-    bool operator!=(const LR1_Item &rhs) const { return !(*this == rhs); }
-
-    inline bool isCurrPosAtEnd() const { return this->currPos >= this->rule.second.size(); }
-
-    friend std::ostream &operator<<(std::ostream &os, const LR1_Item &lr1_item) {
-        os << lr1_item.rule.first << " -> ";
-        for (size_t i = 0; i < lr1_item.rule.second.size(); ++i) {
-            if (lr1_item.currPos == i) {
-                os << " . ";
-            }
-            os << " " << lr1_item.rule.second[i] << " ";
-        }
-        if (lr1_item.currPos == lr1_item.rule.second.size()) {
-            os << " . ";
-        }
-        os << ", " << lr1_item.lookahead;
-        os << std::endl;
-        return os;
-    }
+// A cell that had more than one action, and how it was settled.
+struct Conflict {
+    size_t state;
+    Sym sym;
+    std::vector<Action> actions;
+    // ERROR if the cell was left empty.
+    Action chosen;
+    const char *reason;
 };
 
 struct Grammar {
+   public:
+    // How the LR automaton is built. LALR1 merges the canonical LR(1) states
+    // that share a core: far fewer states, at the risk of reduce/reduce
+    // conflicts LR1 would not have.
+    enum class Construction {
+        LR1,
+        LALR1,
+    };
+
+    // What building the table cost; all zero if the table was mapped.
+    struct ConstructionStats {
+        double seconds = 0;
+        // Cells with more than one action before conflicts were resolved.
+        size_t conflicts = 0;
+        // Reduce/reduce conflicts in LALR(1) states built by merging.
+        size_t mergeConflicts = 0;
+    };
+
+    // What the last gen() did.
+    struct ParseStats {
+        size_t shifts = 0;
+        size_t reductions = 0;
+        // Expressions the ExprParser built.
+        size_t exprHandoffs = 0;
+        // Unit reductions taken by tagging the node below; `reductions`
+        // leaves them out.
+        size_t unitCollapses = 0;
+    };
+
    private:
-    std::map<Nonterminal, std::vector<SymList>> PRODUCE_RULES;
+    // Indices into ORIGIN_PRODUCE_RULES of the rules of each nonterminal.
+    std::map<Nonterminal, std::vector<size_t>> PRODUCE_RULES;
     std::vector<Rule> ORIGIN_PRODUCE_RULES;
 
    private:
@@ -99,60 +140,156 @@ struct Grammar {
     std::set<Terminal> P_TERMINAL_SET;
     std::set<Nonterminal> P_NONTERMINAL_SET;
 
-    // Used for cache.
-   private:
-    std::vector<Sym> symVec;
-    std::map<Sym, size_t> symIndexMap;
+   public:
+    using LR1_TableType = std::map<size_t, std::map<Sym, std::set<Action>, SymLess>>;
 
    private:
-    std::map<size_t, std::map<Sym, std::set<Action>, SymLess>> LR1_Table;
+    // Built by genLR1Table() when the cache is stale and released once
+    // buildParseTable() has filled parseTable from it; otherwise parseTable
+    // is mapped from the cache. The parser itself runs on compressedTable,
+    // packed from parseTable.
+    LR1_TableType LR1_Table;
+    ParseTable parseTable;
+    CompressedParseTable compressedTable;
 
-    using TerminalSet = std::map<Sym, std::set<Terminal>, pluma::SymLess>;
+    Construction construction;
+    // Threads genStates() runs on.
+    unsigned threads;
+    ConflictPolicy policy;
+    ConstructionStats stats;
+    // Filled by resolveConflicts() and kept after construction.
+    std::vector<Conflict> conflicts;
 
    private:
-    TerminalSet FIRST_SET;
-    TerminalSet FOLLOW_SET;
+    // Nullable, FIRST and FOLLOW sets, and FIRST of every rule suffix.
+    FirstFollow firstFollow;
 
    private:
-    std::set<Terminal> &FIRST(const Sym &sym);
-    std::set<Terminal> &FOLLOW(const Sym &sym);
-
-   private:
-    std::map<std::set<LR1_Item>, std::set<LR1_Item>> CLOSURE_SET;
-    std::set<std::set<LR1_Item>> C_SET;
+    // The kernel of every state, indexed by state number.
+    std::vector<ItemSet> C_SET;
     size_t beginStateIndex;
 
    private:
-    std::set<LR1_Item> &CLOSURE(const std::set<LR1_Item> &i);
-    std::set<LR1_Item> &LR1_GOTO(const std::set<LR1_Item> &i, const Sym &sym);
+    ItemSet CLOSURE(const ItemSet &kernel) const;
 
-   private:
-    Action LR1_Table_Read(const size_t &state, const Sym &sym);
+    // The symbol after the dot, or nullptr if the item is complete.
+    const Sym *nextSym(const LR1_Item &item) const;
 
    private:
     // Default constructor is deleted; please use a vector of Rule to initialize
     // it.
     Grammar() = delete;
 
+   private:
+    void addRules(const std::vector<Rule> &pRule);
+
    public:
-    Grammar(const std::string &grammarFile, const std::string &hashFile,
-            const std::vector<Rule> &pRule);
+    // Maps the parse table from `cacheFile`, or builds it and rewrites the
+    // cache if the file is missing or was built for other rules. An empty
+    // `cacheFile` always builds and caches nothing. A table is built on
+    // `threads` threads (0: one per core); the result does not depend on it.
+    Grammar(const std::string &cacheFile, const std::vector<Rule> &pRule,
+            Construction construction = Construction::LR1, unsigned threads = 1,
+            const ConflictPolicy &policy = {});
+
+    // Reads the parse table in place from `image`, a ParseTable image
+    // embedded in the binary; builds it on every core if the image is for
+    // other rules.
+    Grammar(std::span<const uint64_t> image, const std::vector<Rule> &pRule,
+            Construction construction = Construction::LR1, const ConflictPolicy &policy = {});
 
    private:
     void genLR1Table(const std::vector<Rule> &pRule);
+    // Builds C_SET from the kernel of the start state, by `construction`, and
+    // fills LR1_Table from it.
+    void genStates(const ItemSet &beginKernel);
+    // The GOTO kernels out of a state, by symbol, with their lookup keys.
+    struct Expansion;
+    Expansion expand(const ItemSet &kernel, bool withLookahead) const;
+    // Adds the lookaheads of `items` to the items of `state` with the same
+    // cores; true if any were new.
+    static bool mergeInto(ItemSet &state, const ItemSet &items);
+    // The lookaheads on which two complete items of `kernel` both reduce.
+    TerminalBits reduceConflicts(const ItemSet &kernel) const;
+    void addCompletedItemActions(size_t statei, const ItemSet &state);
+    // Counts and logs the reduce/reduce cells of an LALR(1) table that no
+    // canonical LR(1) state with the same core has.
+    void countMergeConflicts(const ItemSet &beginKernel);
+    void addTransitionAction(size_t statei, const Sym &next, size_t target);
+
+    // genLR1Table(), resolveConflicts() and buildParseTable(), timed; logs
+    // the conflict report and releases everything but the table afterwards.
+    void constructTable(const std::vector<Rule> &pRule, uint64_t fingerprint);
+    void releaseConstructionState();
+
+   private:
+    // Leaves one action in every cell of LR1_Table, by `policy`, and records
+    // each conflict it settles.
+    void resolveConflicts();
+    const ConflictPolicy::Precedence *rulePrecedence(size_t rule) const;
+    void buildParseTable(uint64_t fingerprint);
+
+   public:
+    // Bump whenever genStates(), resolveConflicts() or buildParseTable()
+    // change the table they build for the same rules, so the build-tree cache
+    // and embedded images are rebuilt rather than reused.
+    static constexpr uint32_t constructionVersion = 1;
+
+    // Hash of constructionVersion, the rules, the construction, the conflict
+    // policy and the token numbering, stored in the cache.
+    uint64_t fingerprint() const;
 
    private:
-    void writeLR1TableToFile(std::string filename);
-    bool readLR1TableFromFile(std::string filename);
+    // gen() logs every action it takes when set.
+    bool trace = false;
+    // Parse stacks of gen(), kept between parses.
+    std::vector<ParseTable::Word> stateStack;
+    std::vector<AstNode *> nodeStack;
+    ParseStats parseStats;
+
+    // gen() hands the ExprParser a state's lookahead if it is in the state's
+    // exprStarts, and pushes what it builds with the state's exprGoto.
+    const ExprParser *exprParser = nullptr;
+    std::vector<TerminalBits> exprStarts;
+    std::vector<ParseTable::Word> exprGoto;
+
+    // By rule: whether gen() collapses it. Empty if collapsing is off.
+    std::vector<bool> unitRules;
+    // By state: the unit rule the state reduces whatever the lookahead, or
+    // noRule; gen() takes it without looking an action up.
+    static constexpr uint32_t noRule = UINT32_MAX;
+    std::vector<uint32_t> unitStates;
 
    public:
-    Ast gen(std::vector<Sym> str);
+    Ast gen(const TokenStream &tokens);
+    void setTrace(bool trace) { this->trace = trace; }
+    const ParseStats &lastParseStats() const { return this->parseStats; }
+
+    // Lets gen() parse expressions with `parser`, which must outlive the
+    // Grammar; nullptr turns it off. It takes over only where the table
+    // shows that an expression, and nothing else, starts with the lookahead.
+    void setExpressionParser(const ExprParser *parser);
+
+    // Lets gen() reduce a unit rule, one nonterminal or terminal on the
+    // right, by recording it in the rule path of the node already on the
+    // stack rather than wrapping that node in a new one, and pass straight
+    // through states that do nothing but such a reduction. Up to four rules
+    // fit in a path; a longer chain gets a node where the path fills. Off
+    // until turned on, as `main -u` does; the Formatter reads either tree.
+    void setUnitCollapsing(bool collapse);
 
    public:
-    friend std::ostream &operator<<(std::ostream &os, const std::set<LR1_Item> itemSet);
+    const ParseTable &table() const { return this->parseTable; }
+    const CompressedParseTable &compressed() const { return this->compressedTable; }
+    const std::vector<Rule> &rules() const { return this->ORIGIN_PRODUCE_RULES; }
+    const ConstructionStats &constructionStats() const { return this->stats; }
+    // Empty if the table was mapped rather than built.
+    const std::vector<Conflict> &conflictReport() const { return this->conflicts; }
+    void reportConflicts(std::ostream &os) const;
 
+    // These show the LR(1) construction, which is released as soon as the
+    // table is built, so they have something to show only while it runs.
    public:
-    bool checkLR1();
     void display_LR1_Table();
     void display_LR1_C_SET();
     void displayAllRule();
@@ -0,0 +1,139 @@
+#ifndef KEYWORD_HPP_
+#define KEYWORD_HPP_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Symbol.hpp"
+
+namespace pluma {
+
+struct KeywordEntry {
+    std::string_view text;
+    TokenType tokenType;
+};
+
+/**
+ * @brief Reserved words recognized by the lexer (the PLUMA_KEYWORD entries of
+ * TokenSpec.def). Everything else that looks like an identifier is an
+ * IDENTIFIER.
+ */
+inline constexpr KeywordEntry keywordList[]{
+#define PLUMA_TOKEN(name)
+#define PLUMA_PREFIX(name, spelling)
+#define PLUMA_PUNCT(name, spelling)
+#define PLUMA_KEYWORD(name, spelling) {spelling, TokenType::name},
+#include "TokenSpec.def"
+};
+
+namespace keyword_detail {
+
+inline constexpr size_t tableSize = 64;
+
+struct HashSeed {
+    uint32_t first;
+    uint32_t second;
+};
+
+// Mixes the length, the first two bytes and the last byte; every keyword has
+// at least two characters.
+constexpr size_t hash(std::string_view word, HashSeed seed) {
+    return ((uint8_t)word[0] * seed.first + (uint8_t)word[1] * seed.second +
+            (uint8_t)word.back() + word.size()) &
+           (tableSize - 1);
+}
+
+constexpr bool isCollisionFree(HashSeed seed) {
+    bool used[tableSize]{};
+    for (auto &entry : keywordList) {
+        size_t slot = hash(entry.text, seed);
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+// Searched at compile time; fails to compile if the list ever outgrows it.
+constexpr HashSeed findSeed() {
+    for (uint32_t first = 1; first < 256; ++first) {
+        for (uint32_t second = 1; second < 256; ++second) {
+            if (isCollisionFree(HashSeed{first, second})) {
+                return HashSeed{first, second};
+            }
+        }
+    }
+    throw "no collision-free keyword hash seed";
+}
+
+inline constexpr HashSeed seed = findSeed();
+
+constexpr std::array<KeywordEntry, tableSize> buildTable() {
+    std::array<KeywordEntry, tableSize> table{};
+    for (auto &slot : table) {
+        slot = KeywordEntry{"", TokenType::IDENTIFIER};
+    }
+    for (auto &entry : keywordList) {
+        table[hash(entry.text, seed)] = entry;
+    }
+    return table;
+}
+
+inline constexpr std::array<KeywordEntry, tableSize> table = buildTable();
+
+constexpr size_t minLength() {
+    size_t result = keywordList[0].text.size();
+    for (auto &entry : keywordList) {
+        result = entry.text.size() < result ? entry.text.size() : result;
+    }
+    return result;
+}
+
+constexpr size_t maxLength() {
+    size_t result = 0;
+    for (auto &entry : keywordList) {
+        result = entry.text.size() > result ? entry.text.size() : result;
+    }
+    return result;
+}
+
+inline constexpr size_t minKeywordLength = minLength();
+inline constexpr size_t maxKeywordLength = maxLength();
+
+}  // namespace keyword_detail
+
+/**
+ * @brief Classifies an identifier-shaped word with a compile-time perfect hash:
+ * one table probe and one string compare, no allocation.
+ * Returns IDENTIFIER if the word is not reserved.
+ */
+constexpr TokenType lookupKeyword(std::string_view word) {
+    using namespace keyword_detail;
+    if (word.size() < minKeywordLength || word.size() > maxKeywordLength) {
+        return TokenType::IDENTIFIER;
+    }
+    const KeywordEntry &slot = table[hash(word, seed)];
+    return slot.text == word ? slot.tokenType : TokenType::IDENTIFIER;
+}
+
+namespace keyword_detail {
+
+constexpr bool everyKeywordFound() {
+    for (auto &entry : keywordList) {
+        if (lookupKeyword(entry.text) != entry.tokenType) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace keyword_detail
+
+static_assert(keyword_detail::everyKeywordFound());
+static_assert(lookupKeyword("whale") == TokenType::IDENTIFIER);
+
+}  // namespace pluma
+
+#endif
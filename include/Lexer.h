@@ -2,33 +2,79 @@
 #define LEXER_H_
 
 #include <cctype>
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
+#include "Keyword.hpp"
 #include "Symbol.hpp"
+#include "TokenStream.h"
 #include "main.h"
+#include "utils/SourceBuffer.h"
 
 namespace pluma {
 
+// Replace `removed` bytes at `offset` with `inserted`.
+struct TextEdit {
+    size_t offset;
+    size_t removed;
+    std::string inserted;
+};
+
 class Lexer {
    private:
-    std::fstream inputFile;
-    char peek = ' ';
-    int line = 1;
+    // Mapped input; shared with the TokenStream so token offsets stay valid
+    // after the Lexer is gone.
+    std::shared_ptr<const utils::SourceBuffer> source;
+    const char *cursor = nullptr;
+    const char *end = nullptr;
+
+    // Set for the per-chunk lexers of tokenizeParallel(): errors mark the
+    // lexer as failed instead of panicking.
+    bool speculative = false;
+    bool failed = false;
+
+    // The lexemes one worker found in its chunk; defined in Lexer.cpp.
+    struct Chunk;
 
    private:
     Lexer() = delete;
     Lexer(const Lexer &) = delete;
     Lexer(Lexer &&) = delete;
-    Token scan(std::fstream &file);
+    Lexer(std::shared_ptr<const utils::SourceBuffer> source, const char *begin, bool speculative);
+    Token scan();
+    Token lexError(const char *what);
+    void utf8Error(const char *at);
+    void lexChunk(Chunk &chunk);
 
    public:
     Lexer(std::string inputFilename);
-    ~Lexer();
-    std::vector<pluma::Sym> tokenize();
+    explicit Lexer(std::shared_ptr<const utils::SourceBuffer> source);
+    TokenStream tokenize();
+
+    /**
+     * @brief Same stream as tokenize(), lexed by `threads` workers (0: one per
+     * core). The input is cut into chunks at line starts; each chunk is lexed
+     * speculatively on its own thread, then the chunks are stitched in order,
+     * re-lexing sequentially wherever a chunk began inside a comment or a
+     * literal until its tokens line up with the real ones again.
+     * Small inputs are lexed sequentially.
+     */
+    TokenStream tokenizeParallel(unsigned threads = 0);
+
+    /**
+     * @brief Updates `tokens` in place for `edit`; the stream switches to a
+     * new buffer holding the edited text. Only the stretch around the edit is
+     * lexed again: from the last token whose lookahead cannot reach the edit
+     * up to the first token after it that starts where an old token did. The
+     * tokens before are kept, the tokens after only have their offsets
+     * shifted.
+     */
+    static void relex(TokenStream &tokens, const TextEdit &edit);
+
+    size_t inputSize() const { return this->source->size(); }
 };
 
 }  // namespace pluma
 
-#endif
\ No newline at end of file
+#endif
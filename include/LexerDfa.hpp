@@ -0,0 +1,137 @@
+#ifndef LEXER_DFA_HPP_
+#define LEXER_DFA_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+#include "Symbol.hpp"
+
+namespace pluma {
+
+namespace lexer_dfa {
+
+struct Spelling {
+    std::string_view text;
+    TokenType tokenType;
+};
+
+// Operators, punctuators and comment openers from TokenSpec.def.
+inline constexpr Spelling spellings[]{
+#define PLUMA_TOKEN(name)
+#define PLUMA_PREFIX(name, spelling) {spelling, TokenType::name},
+#define PLUMA_PUNCT(name, spelling) {spelling, TokenType::name},
+#define PLUMA_KEYWORD(name, spelling)
+#include "TokenSpec.def"
+};
+
+constexpr size_t countClasses() {
+    bool seen[256]{};
+    size_t count = 1;  // class 0: bytes that appear in no spelling
+    for (auto &spelling : spellings) {
+        for (char c : spelling.text) {
+            count += !seen[(uint8_t)c];
+            seen[(uint8_t)c] = true;
+        }
+    }
+    return count;
+}
+
+constexpr size_t maxStates() {
+    size_t count = 2;  // dead state and start state
+    for (auto &spelling : spellings) {
+        count += spelling.text.size();
+    }
+    return count;
+}
+
+inline constexpr size_t classCount = countClasses();
+inline constexpr size_t stateLimit = maxStates();
+inline constexpr uint8_t deadState = 0;
+inline constexpr uint8_t startState = 1;
+
+static_assert(stateLimit <= 256, "operator DFA states must fit in a byte");
+
+/**
+ * @brief Dense transition table over byte classes: the trie of all spellings,
+ * where a state accepts if some spelling ends there. Bytes that occur in no
+ * spelling share class 0, so a row is `classCount` bytes wide.
+ */
+struct Dfa {
+    uint8_t byteClass[256];
+    uint8_t next[stateLimit][classCount];
+    TokenType accept[stateLimit];
+    size_t stateCount;
+};
+
+constexpr Dfa build() {
+    Dfa dfa{};
+    uint8_t nextClass = 1;
+    for (auto &spelling : spellings) {
+        for (char c : spelling.text) {
+            if (dfa.byteClass[(uint8_t)c] == 0) {
+                dfa.byteClass[(uint8_t)c] = nextClass++;
+            }
+        }
+    }
+    for (auto &accept : dfa.accept) {
+        accept = TokenType::UNKNOWN;
+    }
+
+    dfa.stateCount = 2;
+    for (auto &spelling : spellings) {
+        uint8_t state = startState;
+        for (char c : spelling.text) {
+            uint8_t &target = dfa.next[state][dfa.byteClass[(uint8_t)c]];
+            if (target == deadState) {
+                target = (uint8_t)dfa.stateCount++;
+            }
+            state = target;
+        }
+        dfa.accept[state] = spelling.tokenType;
+    }
+    return dfa;
+}
+
+inline constexpr Dfa dfa = build();
+
+/**
+ * @brief Longest spelling at `p` (maximal munch). Returns the end of the match
+ * and sets `type`, or returns `p` with `type` UNKNOWN if nothing matches.
+ */
+constexpr const char *match(const char *p, const char *end, TokenType &type) {
+    const char *matched = p;
+    type = TokenType::UNKNOWN;
+    uint8_t state = startState;
+    for (const char *q = p; q < end;) {
+        state = dfa.next[state][dfa.byteClass[(uint8_t)*q]];
+        if (state == deadState) {
+            break;
+        }
+        ++q;
+        if (dfa.accept[state] != TokenType::UNKNOWN) {
+            type = dfa.accept[state];
+            matched = q;
+        }
+    }
+    return matched;
+}
+
+constexpr bool everySpellingMatches() {
+    for (auto &spelling : spellings) {
+        TokenType type = TokenType::UNKNOWN;
+        const char *begin = spelling.text.data();
+        const char *end = begin + spelling.text.size();
+        if (match(begin, end, type) != end || type != spelling.tokenType) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(everySpellingMatches());
+
+}  // namespace lexer_dfa
+
+}  // namespace pluma
+
+#endif
@@ -2,7 +2,14 @@
 #define LOGGER_H_
 
 #include <fstream>
+#include <string>
 
-static std::fstream logger("../../log.txt", std::ios::out);
+// Log of the parser: conflict reports, tables built at run time and, with
+// `main -t`, every parse step. It writes nothing until the program names a
+// file with openLog(); main keeps "../../log.txt" relative to its working
+// directory, and tablegen logs into the build tree.
+inline std::ofstream logger;
 
-#endif
\ No newline at end of file
+inline void openLog(const std::string &filename) { logger.open(filename); }
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef PARSE_TABLE_H_
+#define PARSE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Symbol.hpp"
+#include "utils/SourceBuffer.h"
+
+namespace pluma {
+
+/**
+ * @brief Layout of a parse table image, in memory and in the cache file: this
+ * header, then the ACTION, GOTO, rule left-hand side and rule length arrays of
+ * 16-bit words, back to back. Integers are in host byte order; a cache written
+ * on another machine fails the version check and is rebuilt.
+ */
+struct ParseTableHeader {
+    char magic[8];
+    // Grammar::fingerprint() of the grammar the table was built for.
+    uint64_t fingerprint;
+    uint32_t version;
+    uint32_t stateCount;
+    uint32_t terminalCount;
+    uint32_t nonterminalCount;
+    uint32_t ruleCount;
+    uint32_t beginState;
+};
+
+static_assert(sizeof(ParseTableHeader) == 40);
+
+/**
+ * @brief LR(1) ACTION and GOTO tables over dense symbol ids, one 16-bit word
+ * per cell, stored row by row in flat arrays.
+ * A terminal's id is its TokenType + 1 (TK_EOF is 0), so a token indexes its
+ * ACTION column directly and token types the grammar never uses are columns
+ * of errors. Nonterminal ids are given by the Grammar that fills the table.
+ * Each cell holds a single action; conflicts are resolved before they get
+ * here.
+ * A table is either built in memory, or read in place from an image it does
+ * not own: a cache file it maps, or an array compiled into the binary.
+ */
+class ParseTable {
+   public:
+    using Word = uint16_t;
+
+    enum class Kind : uint8_t {
+        ERROR,
+        PUSH_STACK,
+        REDUCE,
+        ACCEPT,
+    };
+
+    // Bump whenever the image layout changes, so old caches are rebuilt;
+    // changes to what goes in it bump Grammar::constructionVersion.
+    static constexpr uint32_t formatVersion = 1;
+
+    // An ACTION word keeps the kind in its top two bits and the target state
+    // or rule in the rest.
+    static constexpr size_t targetBits = 14;
+    static constexpr size_t maxTarget = ((size_t)1 << targetBits) - 1;
+
+    // Empty GOTO cell.
+    static constexpr Word noState = UINT16_MAX;
+
+    static constexpr size_t terminalCount = tokenTypeCount;
+
+    static constexpr Word pack(Kind kind, size_t target) {
+        return (Word)(((size_t)kind << targetBits) | target);
+    }
+    static constexpr Kind kindOf(Word action) { return (Kind)(action >> targetBits); }
+    static constexpr size_t targetOf(Word action) { return action & maxTarget; }
+
+    static constexpr size_t terminalId(TokenType type) { return (size_t)(type + 1); }
+
+   private:
+    const ParseTableHeader *header = nullptr;
+
+    // stateCount x terminalCount
+    const Word *actions = nullptr;
+    // stateCount x nonterminalCount
+    const Word *gotos = nullptr;
+    // Left-hand nonterminal id and right-hand length of each rule.
+    const Word *lhs = nullptr;
+    const Word *lengths = nullptr;
+
+    // Backing store of the image, if the table owns it.
+    std::vector<uint64_t> owned;
+    std::unique_ptr<utils::SourceBuffer> mapped;
+
+   private:
+    ParseTable(const ParseTable &) = delete;
+    ParseTable &operator=(const ParseTable &) = delete;
+
+    static size_t imageSize(size_t stateCount, size_t nonterminalCount, size_t ruleCount);
+
+    // Points the arrays into the image starting at `header`.
+    void attach(const ParseTableHeader *header);
+
+    // Tables built in memory own their image and may be filled in.
+    Word *writable(const Word *cell) { return const_cast<Word *>(cell); }
+
+   public:
+    ParseTable() = default;
+    ParseTable(uint64_t fingerprint, size_t stateCount, size_t nonterminalCount, size_t ruleCount,
+               size_t beginState);
+    ParseTable(ParseTable &&other) noexcept = default;
+    ParseTable &operator=(ParseTable &&other) noexcept = default;
+
+    void setAction(size_t state, TokenType type, Kind kind, size_t target);
+    void setGoto(size_t state, size_t nonterminal, size_t target);
+    void setRule(size_t rule, size_t lhsNonterminal, size_t length);
+
+    // Writes the image to `filename`. Returns false on I/O errors.
+    bool save(const std::string &filename) const;
+
+    // Maps a cache written by save(). Returns false, leaving the table as it
+    // was, if the file is missing, truncated, or was built for another
+    // grammar or format version.
+    bool load(const std::string &filename, uint64_t fingerprint);
+
+    // Reads the table in place from `size` bytes at `image`, which must stay
+    // valid and 8-byte aligned. Fails like load().
+    bool view(const void *image, size_t size, uint64_t fingerprint);
+
+    // The image save() writes, memoryUsage() bytes long.
+    const void *image() const { return this->header; }
+
+    bool isMapped() const { return this->mapped != nullptr; }
+
+    size_t states() const { return this->header->stateCount; }
+    size_t nonterminals() const { return this->header->nonterminalCount; }
+    size_t rules() const { return this->header->ruleCount; }
+    size_t startState() const { return this->header->beginState; }
+
+    Word action(size_t state, TokenType type) const {
+        return this->actions[state * terminalCount + terminalId(type)];
+    }
+
+    // The action taken on an empty (NIL) right-hand side when the lookahead
+    // itself has none.
+    Word epsilonAction(size_t state) const { return this->action(state, TokenType::NIL); }
+
+    Word gotoState(size_t state, size_t nonterminal) const {
+        return this->gotos[state * this->header->nonterminalCount + nonterminal];
+    }
+
+    size_t ruleLhs(size_t rule) const { return this->lhs[rule]; }
+    size_t ruleLength(size_t rule) const { return this->lengths[rule]; }
+
+    // Bytes of the image, header included.
+    size_t memoryUsage() const;
+};
+
+}  // namespace pluma
+
+#endif
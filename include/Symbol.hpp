@@ -1,229 +1,54 @@
 #ifndef SYMBOL_HPP_
 #define SYMBOL_HPP_
 
+#include <cstdint>
 #include <iostream>
-#include <map>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
 namespace pluma {
 
-// The type of a token.
+// The type of a token; the list lives in TokenSpec.def.
 enum TokenType {
     // EOF token.
     TK_EOF = -1,
 
-    // Nil token.
-    NIL,
-
-    // Unknown token.
-    UNKNOWN,
-
-    // Error.
-    ERROR,
-
-    // Number constant.
-    INT_CONST,
-    FLOAT_CONST,
-
-    // Identifier.
-    IDENTIFIER,
-
-    // C-style string constant.
-    STRING_CONST,
-
-    // Character constant.
-    CHAR_CONST,
-
-    // Preprocessing.
-    SHARP,    // "#"
-    INCLUDE,  // "include"
-    DEFINE,   // "define"
-
-    // Comments.
-    BLOCK_COMMENT,  // "//"
-    LINE_COMMENT,   // "/* */"
-
-    // Arithmetic operators.
-    ADD,  // "+"
-    SUB,  // "-"
-    MUL,  // "*"
-    DIV,  // "/"
-    MOD,  // "%"
-
-    // Bitwise operators.
-    BITAND,  // "&"
-    BITOR,   // "|"
-    BITXOR,  // "^"
-    BITNOT,  // "~"
-    LSHIFT,  // "<<"
-    RSHIFT,  // ">>"
-
-    // Logical operators.
-    AND,  // "&&"
-    OR,   // "||"
-    NOT,  // "!"
-
-    // Comparison operators.
-    EQ,   // "=="
-    NEQ,  // "!="
-    LE,   // "<="
-    GE,   // ">="
-    LT,   // "<"
-    GT,   // ">"
-
-    // Assignment operators.
-    ASSIGN,         // "="
-    ADD_ASSIGN,     // "+="
-    SUB_ASSIGN,     // "-="
-    MUL_ASSIGN,     // "*="
-    DIV_ASSIGN,     // "/="
-    MOD_ASSIGN,     // "%="
-    BITAND_ASSIGN,  // "&="
-    BITOR_ASSIGN,   // "|="
-    BITXOR_ASSIGN,  // "^="
-    LSHIFT_ASSIGN,  // "<<="
-    RSHIFT_ASSIGN,  // ">>="
-
-    // Increment/Decrement operators.
-    INCR,  // "++"
-    DECR,  // "--"
-
-    // Brackets.
-    LPAREN,     // "("
-    RPAREN,     // ")"
-    LSBRACKET,  // "["
-    RSBRACKET,  // "]"
-    LBRACE,     // "{"
-    RBRACE,     // "}"
-
-    // Other operators.
-    COMMA,          // ","
-    PERIOD,         // "."
-    ARROW,          // "->"
-    COLON,          // ":"
-    DBL_COLON,      // "::"
-    SEMICOLON,      // ";"
-    QUESTION_MARK,  // "?"
-
-    // Keywords.
-
-    // Type specifier.
-    CHAR,
-    SHORT,
-    INT,
-    LONG,
-    UNSIGNED,
-    SIGNED,
-    FLOAT,
-    DOUBLE,
-    VOID,
-
-    STRUCT,
-    ENUM,
-    UNION,
-
-    // Type qualifier.
-    CONST,
-    VOLATILE,
-
-    // Storage-class specifier.
-    STATIC,
-    EXTERN,
-    TYPEDEF,
-
-    SIZEOF,
-
-    IF,
-    ELSE,
-    WHILE,
-    DO,
-    FOR,
-    SWITCH,
-    CASE,
-    DEFAULT,
-    CONTINUE,
-    BREAK,
-    RETURN,
-    GOTO,
+#define PLUMA_TOKEN(name) name,
+#define PLUMA_PREFIX(name, spelling) name,
+#define PLUMA_PUNCT(name, spelling) name,
+#define PLUMA_KEYWORD(name, spelling) name,
+#include "TokenSpec.def"
 };
 
-/**
- * @brief Keyword map using `std::map`.
- * TODO: To be replaced with my implementation.
- */
-const std::map<std::string, TokenType> keywordMap{
-    // Keyword for basic type
-    {"int", TokenType::INT},
-    {"char", TokenType::CHAR},
-    {"short", TokenType::SHORT},
-    {"long", TokenType::LONG},
-    {"unsigned", TokenType::UNSIGNED},
-    {"signed", TokenType::SIGNED},
-    {"float", TokenType::FLOAT},
-    {"double", TokenType::INT},
-    {"void", TokenType::VOID},
-
-    // Keyword for compound type and enum
-    {"struct", TokenType::STRUCT},
-    {"enum", TokenType::ENUM},
-    {"union", TokenType::UNION},
-
-    // Typedef
-    {"typedef", TokenType::TYPEDEF},
-
-    // Type qualifiers
-    {"const", TokenType::CONST},
-    {"static", TokenType::STATIC},
-    {"volatile", TokenType::VOLATILE},
-    {"extern", TokenType::EXTERN},
-
-    // Sizeof
-    {"sizeof", TokenType::SIZEOF},
-
-    // Control flow
-    {"if", TokenType::IF},
-    {"else", TokenType::ELSE},
-    {"while", TokenType::WHILE},
-    {"do", TokenType::DO},
-    {"for", TokenType::FOR},
-    {"switch", TokenType::SWITCH},
-    {"case", TokenType::CASE},
-    {"default", TokenType::DEFAULT},
-    {"continue", TokenType::CONTINUE},
-    {"break", TokenType::BREAK},
-    {"return", TokenType::RETURN},
-    {"goto", TokenType::GOTO},
-};
+// Number of TokenType values, TK_EOF included.
+inline constexpr size_t tokenTypeCount = 1
+#define PLUMA_TOKEN(name) +1
+#define PLUMA_PREFIX(name, spelling) +1
+#define PLUMA_PUNCT(name, spelling) +1
+#define PLUMA_KEYWORD(name, spelling) +1
+#include "TokenSpec.def"
+    ;
 
 /**
- * @brief Preprocessing directive map using `std::map`.
+ * @brief A lexed token.
+ * `value` does not own its bytes: it points into the source buffer held by the
+ * TokenStream the token came from (or at a string literal for the tokens the
+ * grammar is written with). Copying a Token is a plain memberwise copy.
  */
-const std::map<std::string, TokenType> preprocessorMap{
-    {"include", TokenType::INCLUDE},
-    {"define", TokenType::DEFINE},
-};
-
 struct Token {
-    std::string value;
-    TokenType tokenType;
+    // `index` of tokens that are not in any TokenStream.
+    static constexpr uint32_t noIndex = UINT32_MAX;
 
-    std::vector<Token> comments;
+    std::string_view value;
+    TokenType tokenType;
 
-    size_t line;
+    // Position in the TokenStream, used to find the comments that follow it.
+    uint32_t index;
 
     Token();
-    Token(std::string _value, TokenType _type, size_t _line = 0, std::vector<Token> _comments = {});
-    Token(const Token &other);
-    Token(Token &&other);
-    ~Token() = default;
-
-    // copy assign operator required by std::variant
-    Token &operator=(const Token &other);
-
-    // move assign operator
-    Token &operator=(Token &&other);
+    Token(std::string_view _value, TokenType _type, uint32_t _index = noIndex);
 };
 
 // 终结符 / 非终结符
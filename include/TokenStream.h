@@ -0,0 +1,95 @@
+#ifndef TOKEN_STREAM_H_
+#define TOKEN_STREAM_H_
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Symbol.hpp"
+#include "utils/LineIndex.h"
+#include "utils/SourceBuffer.h"
+
+namespace pluma {
+
+// A comment and the index of the token it follows.
+struct Comment {
+    uint32_t tokenIndex;
+    uint32_t offset;
+    uint32_t length;
+};
+
+/**
+ * @brief The lexer's output as parallel arrays: one byte of token type plus the
+ * byte offset and length of each token in the shared source buffer.
+ * Comments live in a separate table sorted by the index of the token they
+ * follow, so tokens without comments cost nothing for them. Lines are not
+ * stored; the line index is built the first time a position is asked for.
+ */
+class TokenStream {
+   private:
+    std::shared_ptr<const utils::SourceBuffer> source;
+
+    std::vector<uint8_t> types;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+
+    // Built on demand by lines().
+    mutable std::shared_ptr<const utils::LineIndex> lineIndex;
+
+    std::vector<Comment> comments;
+
+   public:
+    TokenStream() = default;
+    explicit TokenStream(std::shared_ptr<const utils::SourceBuffer> source);
+
+    void push(TokenType type, const char *begin, const char *end);
+
+    // Attaches a comment to the last pushed token; comments before the first
+    // token are dropped.
+    void pushComment(const char *begin, const char *end);
+
+    // Replaces tokens [first, last) and their comments with all of
+    // `replacement`, moves the tokens after by `offsetDelta` bytes, and
+    // switches to replacement's buffer. Used to patch the stream after an
+    // edit.
+    void splice(size_t first, size_t last, const TokenStream &replacement, int64_t offsetDelta);
+
+    size_t size() const { return this->types.size(); }
+    bool empty() const { return this->types.empty(); }
+
+    TokenType type(size_t i) const { return (TokenType)(int8_t)this->types[i]; }
+    uint32_t offset(size_t i) const { return this->offsets[i]; }
+    uint32_t length(size_t i) const { return this->lengths[i]; }
+
+    // Line index of the buffer, built on first use.
+    const utils::LineIndex &lines() const;
+    size_t line(size_t i) const { return this->lines().line(this->offsets[i]); }
+    utils::SourcePosition position(size_t i) const {
+        return this->lines().position(this->offsets[i]);
+    }
+
+    std::string_view text(size_t i) const {
+        return std::string_view(this->source->data() + this->offsets[i], this->lengths[i]);
+    }
+    std::string_view text(const Comment &comment) const {
+        return std::string_view(this->source->data() + comment.offset, comment.length);
+    }
+
+    // Materializes token i as a Token viewing the source buffer.
+    Token token(size_t i) const;
+
+    std::span<const Comment> commentsOf(size_t i) const;
+    std::span<const Comment> allComments() const { return this->comments; }
+
+    const utils::SourceBuffer &buffer() const { return *this->source; }
+    std::shared_ptr<const utils::SourceBuffer> sharedBuffer() const { return this->source; }
+
+    // Bytes held by the arrays and the comment table (not the line index).
+    size_t memoryUsage() const;
+};
+
+}  // namespace pluma
+
+#endif
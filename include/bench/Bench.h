@@ -0,0 +1,60 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace pluma {
+
+class TokenStream;
+
+namespace bench {
+
+struct Stopwatch {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    void restart() { this->begin = std::chrono::steady_clock::now(); }
+
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - this->begin)
+            .count();
+    }
+};
+
+// Writes `repeat` copies of the input file to a temporary file and returns its
+// path, so small samples can be scaled up to multi-megabyte inputs.
+std::string scaleInput(const std::string &filename, size_t repeat);
+
+// Like scaleInput(), but keeps the preprocessor lines of the first copy only,
+// so the result is still one program the C grammar accepts.
+std::string scaleProgram(const std::string &filename, size_t repeat);
+
+// Prints one result row: "<suite>/<name>  <value> <unit>".
+void report(const std::string &suite, const std::string &name, double value,
+            const std::string &unit);
+
+// Resident set size of the process, and its high-water mark since the last
+// resetPeakResident(), in KiB, read from /proc; 0 where that is missing.
+size_t residentKiB();
+size_t peakResidentKiB();
+void resetPeakResident();
+
+// Compares every token and comment field; prints the first difference.
+bool sameStream(const TokenStream &expected, const TokenStream &actual);
+
+// Benchmark suites. Each returns false if a correctness check failed.
+bool lexerBench(const std::string &filename, size_t repeat);
+bool keywordBench(const std::string &filename, size_t repeat);
+bool dfaBench(const std::string &filename, size_t repeat);
+bool parallelBench(const std::string &filename, size_t repeat);
+bool incrementalBench(const std::string &filename, size_t repeat);
+bool utf8Bench(const std::string &filename, size_t repeat);
+bool parseBench(const std::string &filename, size_t repeat);
+bool constructBench(const std::string &filename, size_t repeat);
+
+}  // namespace bench
+
+}  // namespace pluma
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef LEGACY_LEXER_H_
+#define LEGACY_LEXER_H_
+
+#include <fstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "Symbol.hpp"
+
+namespace pluma {
+
+namespace bench {
+
+/**
+ * @brief The original fstream lexer and its token representation (an owned
+ * string, a nested comments vector and a line per token, wrapped in the
+ * Terminal/Nonterminal variant), kept as the reference the lexer benchmarks
+ * compare against.
+ */
+struct LegacyToken {
+    std::string value;
+    TokenType tokenType;
+
+    std::vector<LegacyToken> comments;
+
+    size_t line;
+
+    LegacyToken();
+    LegacyToken(std::string _value, TokenType _type, size_t _line = 0);
+};
+
+struct LegacyTerminal {
+    LegacyToken token;
+};
+
+using LegacySym = std::variant<LegacyTerminal, Nonterminal>;
+
+class LegacyLexer {
+   private:
+    std::fstream inputFile;
+    char peek = ' ';
+    int line = 1;
+
+   private:
+    LegacyToken scan(std::fstream &file);
+
+   public:
+    LegacyLexer(const std::string &inputFilename);
+    std::vector<LegacySym> tokenize();
+};
+
+}  // namespace bench
+
+}  // namespace pluma
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef C_DIRECT_PARSER_H_
+#define C_DIRECT_PARSER_H_
+
+#include "../Ast.hpp"
+#include "../TokenStream.h"
+
+namespace pluma {
+
+// Parses `tokens` with the C grammar's LR automaton compiled to code. It
+// carries out plain Grammar::gen(), without an ExprParser or unit collapsing,
+// and builds the same Ast as that; a CParser as shipped hands expressions to
+// its ExprParser and builds a different, flatter Ast. It is not a drop-in
+// replacement for CParser.
+// Generated at build time by parsergen (src/tools/ParserGen.cpp) into
+// CDirectParser.cpp in the build tree; built with -DPLUMA_DIRECT_PARSER=ON.
+Ast cDirectParse(const TokenStream &tokens);
+
+}  // namespace pluma
+
+#endif
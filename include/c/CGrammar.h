@@ -0,0 +1,27 @@
+#ifndef C_GRAMMAR_H_
+#define C_GRAMMAR_H_
+
+#include <vector>
+
+#include "../Grammar.hpp"
+#include "../Symbol.hpp"
+
+namespace pluma {
+
+// The rules of the C grammar; the first one is the augmented start rule.
+std::vector<Rule> cGrammarRules();
+
+// The conditional operator groups to the right. Every other conflict of the
+// C grammar (the dangling else among them) shifts, or takes the lowest rule.
+ConflictPolicy cGrammarConflictPolicy();
+
+// Parses the `expr` of the C grammar by the C operator precedences.
+const ExprParser &cExprParser();
+
+// LALR(1) merging adds no conflicts to the C grammar and cuts its 1017
+// canonical LR(1) states to 308.
+inline constexpr Grammar::Construction cGrammarConstruction = Grammar::Construction::LALR1;
+
+}  // namespace pluma
+
+#endif
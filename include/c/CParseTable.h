@@ -0,0 +1,16 @@
+#ifndef C_PARSE_TABLE_H_
+#define C_PARSE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pluma {
+
+// ParseTable image of cGrammarRules(), generated at build time by tablegen
+// (src/tools/TableGen.cpp) into CParseTable.cpp in the build tree.
+extern const uint64_t cParseTableImage[];
+extern const size_t cParseTableWords;
+
+}  // namespace pluma
+
+#endif
@@ -1,4 +1,6 @@
 #include "../Parser.h"
+#include "CGrammar.h"
+#include "CParseTable.h"
 
 namespace pluma {
 
@@ -0,0 +1,47 @@
+#ifndef LINE_INDEX_H_
+#define LINE_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pluma {
+
+namespace utils {
+
+// 1-based line and column; the column counts UTF-8 characters, not bytes.
+struct SourcePosition {
+    size_t line;
+    size_t column;
+};
+
+/**
+ * @brief Offsets of the line starts of a buffer, collected in one vectorized
+ * pass. The lexer does not track lines; this is built only when a line number
+ * is actually needed (diagnostics), and positions are found by binary search.
+ */
+class LineIndex {
+   private:
+    const char *bytes;
+    size_t length;
+    // starts[0] == 0; one entry per line.
+    std::vector<uint32_t> starts;
+
+   public:
+    LineIndex(const char *begin, const char *end);
+
+    size_t lineCount() const { return this->starts.size(); }
+
+    // Line containing the byte at `offset` (or the end of the buffer).
+    size_t line(size_t offset) const;
+
+    SourcePosition position(size_t offset) const;
+
+    size_t memoryUsage() const { return this->starts.capacity() * sizeof(uint32_t); }
+};
+
+}  // namespace utils
+
+}  // namespace pluma
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pluma {
+
+namespace utils {
+
+/**
+ * @brief Byte-class scanning kernels used by the buffer lexer.
+ * Each kernel classifies 16 (SSE2) or 32 (AVX2) bytes per step and jumps to the
+ * first "interesting" byte. The widest level supported by the CPU is picked on
+ * first use; a scalar version is always available.
+ */
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2,
+};
+
+SimdLevel simdLevel();
+
+// Best level the running CPU supports.
+SimdLevel maxSimdLevel();
+
+// Forces a level (clamped to what the CPU supports); mainly for benchmarks.
+void setSimdLevel(SimdLevel level);
+
+const char *simdLevelName(SimdLevel level);
+
+// First byte that is not ' ', '\t', '\n', '\r', '\v' or '\f'.
+const char *skipBlanks(const char *p, const char *end);
+
+// First byte that is not [A-Za-z0-9_].
+const char *skipIdentifier(const char *p, const char *end);
+
+// Position of the '*' of the first "*/", or `end`.
+const char *findBlockCommentEnd(const char *p, const char *end);
+
+// First '"', '\\' or '\n', or `end`.
+const char *findStringSpecial(const char *p, const char *end);
+
+// Start of the first ill-formed UTF-8 sequence in [p, end), or `end`. `p` must
+// be at a character boundary.
+const char *validateUtf8(const char *p, const char *end);
+
+// Appends `base` plus the offset from `p` of the byte after each '\n' in
+// [p, end), i.e. the offsets of the lines that start there.
+void appendLineStarts(const char *p, const char *end, uint32_t base,
+                      std::vector<uint32_t> &starts);
+
+}  // namespace utils
+
+}  // namespace pluma
+
+#endif
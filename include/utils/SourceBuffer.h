@@ -0,0 +1,58 @@
+#ifndef SOURCE_BUFFER_H_
+#define SOURCE_BUFFER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pluma {
+
+namespace utils {
+
+/**
+ * @brief Read-only view of a whole input file.
+ * Regular files are mapped with mmap; pipes, character devices and files that
+ * fail to map are read into an owned buffer instead. The bytes stay valid and
+ * unmoved for the lifetime of the object.
+ */
+class SourceBuffer {
+   private:
+    const char *bytes = nullptr;
+    size_t length = 0;
+
+    // Non-null only when the bytes come from mmap.
+    void *mapped = nullptr;
+
+    // Used by the read-into-buffer fallback.
+    std::vector<char> owned;
+
+   private:
+    SourceBuffer(const SourceBuffer &) = delete;
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+    bool readAll(int fd);
+
+   public:
+    SourceBuffer() = default;
+    // Takes over bytes already in memory, e.g. an edited copy of a file.
+    explicit SourceBuffer(std::vector<char> bytes);
+    SourceBuffer(SourceBuffer &&other) noexcept;
+    SourceBuffer &operator=(SourceBuffer &&other) noexcept;
+    ~SourceBuffer();
+
+    // Returns false if the file cannot be opened or read.
+    bool open(const std::string &filename);
+
+    bool isMapped() const { return this->mapped != nullptr; }
+
+    const char *data() const { return this->bytes; }
+    size_t size() const { return this->length; }
+    const char *begin() const { return this->bytes; }
+    const char *end() const { return this->bytes + this->length; }
+};
+
+}  // namespace utils
+
+}  // namespace pluma
+
+#endif
@@ -0,0 +1,158 @@
+#include "CompressedParseTable.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace pluma {
+
+// The significant cells of one row: (column, word).
+using Row = std::vector<std::pair<size_t, ParseTable::Word>>;
+
+// Overlays the rows into one comb vector, each at the lowest offset where all
+// of its cells land on free slots; row i owns its slots in `check` as i.
+// Returns the offsets. `next` and `check` are sized so that every offset plus
+// a column below `width` is in bounds.
+static std::vector<uint32_t> packRows(const std::vector<Row> &rows, size_t width,
+                                      std::vector<ParseTable::Word> &next,
+                                      std::vector<ParseTable::Word> &check) {
+    // Placing the fullest rows first keeps the comb dense.
+    std::vector<size_t> order(rows.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&rows](size_t lhs, size_t rhs) {
+        return rows[lhs].size() > rows[rhs].size();
+    });
+
+    std::vector<uint32_t> base(rows.size(), 0);
+    next.clear();
+    check.clear();
+    // Every slot below it is taken, so no row's first cell can land there.
+    size_t lowestFree = 0;
+    for (size_t row : order) {
+        if (rows[row].empty()) {
+            continue;
+        }
+        size_t firstColumn = rows[row].front().first;
+        size_t offset = lowestFree > firstColumn ? lowestFree - firstColumn : 0;
+        auto isFree = [&check](size_t i) {
+            return i >= check.size() || check[i] == ParseTable::noState;
+        };
+        while (!std::all_of(rows[row].begin(), rows[row].end(),
+                            [&](auto &cell) { return isFree(offset + cell.first); })) {
+            // Skip straight to the next offset whose first cell is free.
+            do {
+                ++offset;
+            } while (!isFree(offset + firstColumn));
+        }
+        base[row] = (uint32_t)offset;
+        for (auto &[column, word] : rows[row]) {
+            size_t i = offset + column;
+            if (i >= check.size()) {
+                next.resize(i + 1, 0);
+                check.resize(i + 1, ParseTable::noState);
+            }
+            next[i] = word;
+            check[i] = (ParseTable::Word)row;
+        }
+        while (lowestFree < check.size() && check[lowestFree] != ParseTable::noState) {
+            ++lowestFree;
+        }
+    }
+    size_t maxBase = base.empty() ? 0 : *std::max_element(base.begin(), base.end());
+    next.resize(std::max(next.size(), maxBase + width), 0);
+    check.resize(std::max(check.size(), maxBase + width), ParseTable::noState);
+    return base;
+}
+
+// The most frequent word among `words`, the smallest on ties, or `fallback`
+// if there are none. Sorts `words`.
+static ParseTable::Word mostCommon(std::vector<ParseTable::Word> &words,
+                                   ParseTable::Word fallback) {
+    std::sort(words.begin(), words.end());
+    ParseTable::Word result = fallback;
+    size_t best = 0;
+    for (size_t begin = 0, end = 0; begin < words.size(); begin = end) {
+        while (end < words.size() && words[end] == words[begin]) {
+            ++end;
+        }
+        if (end - begin > best) {
+            best = end - begin;
+            result = words[begin];
+        }
+    }
+    return result;
+}
+
+CompressedParseTable::CompressedParseTable(const ParseTable &table)
+    : beginState(table.startState()) {
+    const ParseTable::Word error = ParseTable::pack(Kind::ERROR, 0);
+
+    std::vector<Row> actionRows(table.states());
+    this->fallback.assign(table.states(), error);
+    std::vector<Word> reductions;
+    for (size_t state = 0; state < table.states(); ++state) {
+        reductions.clear();
+        for (size_t column = 0; column < ParseTable::terminalCount; ++column) {
+            Word action = table.action(state, (TokenType)((int)column - 1));
+            if (ParseTable::kindOf(action) == Kind::REDUCE) {
+                reductions.push_back(action);
+            }
+        }
+        // A state with a NIL action falls back to it, not to a reduction;
+        // it keeps all of its reductions in the comb.
+        Word defaultAction = table.epsilonAction(state);
+        if (ParseTable::kindOf(defaultAction) == Kind::ERROR) {
+            defaultAction = mostCommon(reductions, error);
+        }
+        this->fallback[state] = defaultAction;
+
+        for (size_t column = 0; column < ParseTable::terminalCount; ++column) {
+            Word action = table.action(state, (TokenType)((int)column - 1));
+            bool isDefaultReduction =
+                ParseTable::kindOf(action) == Kind::REDUCE && action == defaultAction;
+            if (ParseTable::kindOf(action) != Kind::ERROR && !isDefaultReduction) {
+                actionRows[state].emplace_back(column, action);
+            }
+        }
+    }
+    this->actionBase =
+        packRows(actionRows, ParseTable::terminalCount, this->actionNext, this->actionCheck);
+
+    // One pass over the GOTO rows, in memory order, gathers every column.
+    std::vector<Row> gotoColumns(table.nonterminals());
+    for (size_t state = 0; state < table.states(); ++state) {
+        for (size_t nonterminal = 0; nonterminal < table.nonterminals(); ++nonterminal) {
+            Word target = table.gotoState(state, nonterminal);
+            if (target != ParseTable::noState) {
+                gotoColumns[nonterminal].emplace_back(state, target);
+            }
+        }
+    }
+    this->gotoDefault.assign(table.nonterminals(), ParseTable::noState);
+    for (size_t nonterminal = 0; nonterminal < table.nonterminals(); ++nonterminal) {
+        Row &column = gotoColumns[nonterminal];
+        std::vector<Word> targets;
+        for (auto &[state, target] : column) {
+            targets.push_back(target);
+        }
+        Word defaultTarget = mostCommon(targets, ParseTable::noState);
+        this->gotoDefault[nonterminal] = defaultTarget;
+        std::erase_if(column, [defaultTarget](auto &cell) { return cell.second == defaultTarget; });
+    }
+    this->gotoBase = packRows(gotoColumns, table.states(), this->gotoNext, this->gotoCheck);
+
+    for (size_t rule = 0; rule < table.rules(); ++rule) {
+        this->lhs.push_back((Word)table.ruleLhs(rule));
+        this->lengths.push_back((Word)table.ruleLength(rule));
+    }
+}
+
+size_t CompressedParseTable::memoryUsage() const {
+    return (this->actionBase.size() + this->gotoBase.size()) * sizeof(uint32_t) +
+           (this->actionNext.size() + this->actionCheck.size() + this->fallback.size() +
+            this->gotoNext.size() + this->gotoCheck.size() + this->gotoDefault.size() +
+            this->lhs.size() + this->lengths.size()) *
+               sizeof(Word);
+}
+
+}  // namespace pluma
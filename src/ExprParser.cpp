@@ -0,0 +1,211 @@
+#include "ExprParser.h"
+
+#include <initializer_list>
+#include <vector>
+
+namespace pluma {
+
+namespace {
+
+AstNode *leaf(const TokenStream &tokens, size_t &pos) {
+    return new AstNode(Terminal{tokens.token(pos++)});
+}
+
+AstNode *branch(const Nonterminal &sym, std::initializer_list<AstNode *> sons) {
+    AstNode *node = new AstNode(sym);
+    for (AstNode *son : sons) {
+        node->appendSon(son);
+    }
+    return node;
+}
+
+// Frees a tree built before giving up. ~AstNode only destroys its sons in
+// place, so they are unlinked and deleted one by one.
+void discard(AstNode *root) {
+    std::vector<AstNode *> pending{root};
+    while (!pending.empty()) {
+        AstNode *node = pending.back();
+        pending.pop_back();
+        if (node == nullptr) {
+            continue;
+        }
+        pending.push_back(node->son);
+        pending.push_back(node->brother);
+        node->son = node->brother = nullptr;
+        delete node;
+    }
+}
+
+}  // namespace
+
+ExprParser::ExprParser(const Table &table)
+    : entry(table.nonterminal), conditionalLevel(table.conditionalLevel) {
+    for (auto &[type, op] : table.binary) {
+        this->levels[ParseTable::terminalId(type)] = op.level;
+        this->rightAssociative[ParseTable::terminalId(type)] = op.rightAssociative;
+    }
+    for (TokenType type : table.prefix) {
+        this->prefix[ParseTable::terminalId(type)] = true;
+    }
+    for (TokenType type : table.operands) {
+        this->operands[ParseTable::terminalId(type)] = true;
+    }
+}
+
+bool ExprParser::startsExpression(TokenType type) const {
+    size_t id = ParseTable::terminalId(type);
+    return this->operands[id] || this->prefix[id] || type == TokenType::LPAREN;
+}
+
+AstNode *ExprParser::parse(const TokenStream &tokens, size_t &pos) const {
+    size_t end = pos;
+    AstNode *expr = this->parseExpr(tokens, end, 0);
+    if (expr != nullptr) {
+        pos = end;
+    }
+    return expr;
+}
+
+AstNode *ExprParser::parseExpr(const TokenStream &tokens, size_t &pos, int minLevel) const {
+    AstNode *lhs = this->parseUnary(tokens, pos);
+    if (lhs == nullptr) {
+        return nullptr;
+    }
+    while (1) {
+        TokenType type = tokens.type(pos);
+        if (type == TokenType::QUESTION_MARK && this->conditionalLevel >= minLevel) {
+            AstNode *question = leaf(tokens, pos);
+            AstNode *then = this->parseExpr(tokens, pos, 0);
+            if (then == nullptr || tokens.type(pos) != TokenType::COLON) {
+                discard(branch(this->conditionalExpr, {lhs, question, then}));
+                return nullptr;
+            }
+            AstNode *colon = leaf(tokens, pos);
+            AstNode *otherwise = this->parseExpr(tokens, pos, this->conditionalLevel);
+            lhs = branch(this->conditionalExpr, {lhs, question, then, colon, otherwise});
+            if (otherwise == nullptr) {
+                discard(lhs);
+                return nullptr;
+            }
+            continue;
+        }
+
+        int level = this->levels[ParseTable::terminalId(type)];
+        if (level == 0 || level < minLevel) {
+            return lhs;
+        }
+        AstNode *op = leaf(tokens, pos);
+        bool right = this->rightAssociative[ParseTable::terminalId(type)];
+        AstNode *rhs = this->parseExpr(tokens, pos, right ? level : level + 1);
+        lhs = branch(this->binaryExpr, {lhs, op, rhs});
+        if (rhs == nullptr) {
+            discard(lhs);
+            return nullptr;
+        }
+    }
+}
+
+AstNode *ExprParser::parseUnary(const TokenStream &tokens, size_t &pos) const {
+    if (!this->prefix[ParseTable::terminalId(tokens.type(pos))]) {
+        return this->parsePostfix(tokens, pos);
+    }
+    AstNode *op = leaf(tokens, pos);
+    AstNode *operand = this->parseUnary(tokens, pos);
+    if (operand == nullptr) {
+        discard(op);
+        return nullptr;
+    }
+    return branch(this->unaryExpr, {op, operand});
+}
+
+AstNode *ExprParser::parsePostfix(const TokenStream &tokens, size_t &pos) const {
+    AstNode *node = this->parsePrimary(tokens, pos);
+    if (node == nullptr) {
+        return nullptr;
+    }
+    while (1) {
+        switch (tokens.type(pos)) {
+            case TokenType::LSBRACKET: {
+                AstNode *open = leaf(tokens, pos);
+                AstNode *index = this->parseExpr(tokens, pos, 0);
+                if (index == nullptr || tokens.type(pos) != TokenType::RSBRACKET) {
+                    discard(branch(this->postfixExpr, {node, open, index}));
+                    return nullptr;
+                }
+                node = branch(this->postfixExpr, {node, open, index, leaf(tokens, pos)});
+                break;
+            }
+            case TokenType::PERIOD:
+            case TokenType::ARROW: {
+                AstNode *op = leaf(tokens, pos);
+                AstNode *member = this->parsePrimary(tokens, pos);
+                node = branch(this->postfixExpr, {node, op, member});
+                if (member == nullptr) {
+                    discard(node);
+                    return nullptr;
+                }
+                break;
+            }
+            case TokenType::INCR:
+            case TokenType::DECR: {
+                node = branch(this->postfixExpr, {node, leaf(tokens, pos)});
+                break;
+            }
+            default: {
+                return node;
+            }
+        }
+    }
+}
+
+AstNode *ExprParser::parsePrimary(const TokenStream &tokens, size_t &pos) const {
+    TokenType type = tokens.type(pos);
+    if (type == TokenType::IDENTIFIER && tokens.type(pos + 1) == TokenType::LPAREN) {
+        return this->parseCall(tokens, pos);
+    }
+    if (this->operands[ParseTable::terminalId(type)]) {
+        return leaf(tokens, pos);
+    }
+    if (type != TokenType::LPAREN) {
+        return nullptr;
+    }
+    // The C grammar reads `( id )` and `( id *` as the start of a cast.
+    if (pos + 2 < tokens.size() && tokens.type(pos + 1) == TokenType::IDENTIFIER &&
+        (tokens.type(pos + 2) == TokenType::RPAREN || tokens.type(pos + 2) == TokenType::MUL)) {
+        return nullptr;
+    }
+    AstNode *open = leaf(tokens, pos);
+    AstNode *inner = this->parseExpr(tokens, pos, 0);
+    if (inner == nullptr || tokens.type(pos) != TokenType::RPAREN) {
+        discard(branch(this->primaryExpr, {open, inner}));
+        return nullptr;
+    }
+    return branch(this->primaryExpr, {open, inner, leaf(tokens, pos)});
+}
+
+AstNode *ExprParser::parseCall(const TokenStream &tokens, size_t &pos) const {
+    AstNode *name = leaf(tokens, pos);
+    AstNode *open = leaf(tokens, pos);
+    // Left-recursive, as the grammar builds it: ((a , b) , c).
+    AstNode *params = new AstNode(this->actualParams);
+    if (tokens.type(pos) != TokenType::RPAREN) {
+        AstNode *param = this->parseExpr(tokens, pos, 0);
+        params->appendSon(param);
+        while (param != nullptr && tokens.type(pos) == TokenType::COMMA) {
+            AstNode *comma = leaf(tokens, pos);
+            param = this->parseExpr(tokens, pos, 0);
+            params = branch(this->actualParams, {params, comma, param});
+        }
+        if (param == nullptr) {
+            discard(branch(this->funcCall, {name, open, params}));
+            return nullptr;
+        }
+    }
+    if (tokens.type(pos) != TokenType::RPAREN) {
+        discard(branch(this->funcCall, {name, open, params}));
+        return nullptr;
+    }
+    return branch(this->funcCall, {name, open, params, leaf(tokens, pos)});
+}
+
+}  // namespace pluma
@@ -0,0 +1,180 @@
+#include "FirstFollow.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace pluma {
+
+// Makes sets[x] the union of sets[y] over every y reachable from x along
+// `edges`. Each component is found by Tarjan's traversal and its members all
+// get the root's set, so every edge is followed once.
+static void digraph(std::vector<TerminalBits> &sets,
+                    const std::vector<std::vector<size_t>> &edges) {
+    // 0: not visited yet; SIZE_MAX: component finished.
+    std::vector<size_t> depth(sets.size(), 0);
+    std::vector<size_t> stack;
+    auto traverse = [&](auto &self, size_t x) -> void {
+        stack.push_back(x);
+        size_t d = stack.size();
+        depth[x] = d;
+        for (size_t y : edges[x]) {
+            if (depth[y] == 0) {
+                self(self, y);
+            }
+            depth[x] = std::min(depth[x], depth[y]);
+            sets[x] |= sets[y];
+        }
+        if (depth[x] == d) {
+            // x is the root of a component, which is everything above it.
+            size_t top;
+            do {
+                top = stack.back();
+                stack.pop_back();
+                depth[top] = SIZE_MAX;
+                sets[top] = sets[x];
+            } while (top != x);
+        }
+    };
+    for (size_t x = 0; x < sets.size(); ++x) {
+        if (depth[x] == 0) {
+            traverse(traverse, x);
+        }
+    }
+}
+
+FirstFollow::FirstFollow(const std::vector<Rule> &rules) {
+    // Symbols of the rules as ids: terminal ids below terminalCount,
+    // nonterminal ids above.
+    constexpr size_t terminalCount = ParseTable::terminalCount;
+    auto idOf = [this](const Nonterminal &nonterminal) {
+        auto [found, isNew] = this->ids.emplace(nonterminal, this->names.size());
+        if (isNew) {
+            this->names.push_back(nonterminal);
+        }
+        return found->second;
+    };
+    std::vector<size_t> lhs;
+    std::vector<std::vector<size_t>> rhs(rules.size());
+    for (size_t r = 0; r < rules.size(); ++r) {
+        lhs.push_back(idOf(rules[r].first));
+        for (auto &sym : rules[r].second) {
+            if (std::holds_alternative<Terminal>(sym)) {
+                rhs[r].push_back(ParseTable::terminalId(std::get<Terminal>(sym).token.tokenType));
+            } else {
+                rhs[r].push_back(terminalCount + idOf(std::get<Nonterminal>(sym)));
+            }
+        }
+    }
+    size_t count = this->names.size();
+
+    // Nullable: a rule is, once every symbol of it is; rules with a terminal
+    // other than NIL never are.
+    this->nullable.assign(count, false);
+    std::vector<size_t> pending(rules.size(), 0);
+    std::vector<std::vector<size_t>> occurrences(count);
+    std::vector<size_t> worklist;
+    auto markNullable = [this, &worklist](size_t id) {
+        if (!this->nullable[id]) {
+            this->nullable[id] = true;
+            worklist.push_back(id);
+        }
+    };
+    for (size_t r = 0; r < rules.size(); ++r) {
+        if (std::any_of(rhs[r].begin(), rhs[r].end(),
+                        [](size_t sym) { return sym < terminalCount && sym != nilId; })) {
+            continue;
+        }
+        for (size_t sym : rhs[r]) {
+            if (sym >= terminalCount) {
+                ++pending[r];
+                occurrences[sym - terminalCount].push_back(r);
+            }
+        }
+        if (pending[r] == 0) {
+            markNullable(lhs[r]);
+        }
+    }
+    while (!worklist.empty()) {
+        size_t id = worklist.back();
+        worklist.pop_back();
+        for (size_t r : occurrences[id]) {
+            if (--pending[r] == 0) {
+                markNullable(lhs[r]);
+            }
+        }
+    }
+
+    // FIRST: A gets every terminal and the FIRST of every nonterminal that
+    // can start one of its rules, that is, that only nullable symbols
+    // precede.
+    this->firstSets.assign(count, TerminalBits());
+    std::vector<std::vector<size_t>> edges(count);
+    for (size_t r = 0; r < rules.size(); ++r) {
+        for (size_t sym : rhs[r]) {
+            if (sym < terminalCount) {
+                if (sym != nilId) {
+                    this->firstSets[lhs[r]].set(sym);
+                    break;
+                }
+            } else {
+                edges[lhs[r]].push_back(sym - terminalCount);
+                if (!this->nullable[sym - terminalCount]) {
+                    break;
+                }
+            }
+        }
+    }
+    digraph(this->firstSets, edges);
+    for (size_t id = 0; id < count; ++id) {
+        if (this->nullable[id]) {
+            this->firstSets[id].set(nilId);
+        }
+    }
+
+    // FIRST of every rule suffix, from the end of the rule back.
+    this->suffixFirstSets.resize(rules.size());
+    for (size_t r = 0; r < rules.size(); ++r) {
+        auto &suffixFirst = this->suffixFirstSets[r];
+        suffixFirst.assign(rhs[r].size() + 1, TerminalBits());
+        suffixFirst[rhs[r].size()].set(nilId);
+        for (size_t pos = rhs[r].size(); pos-- > 0;) {
+            size_t sym = rhs[r][pos];
+            if (sym < terminalCount) {
+                suffixFirst[pos].set(sym);
+            } else {
+                suffixFirst[pos] = this->firstSets[sym - terminalCount];
+            }
+            if (suffixFirst[pos].test(nilId)) {
+                suffixFirst[pos].reset(nilId);
+                suffixFirst[pos] |= suffixFirst[pos + 1];
+            }
+        }
+    }
+
+    // FOLLOW: in A -> aBb, B is followed by FIRST(b), and by FOLLOW(A) if b
+    // is nullable.
+    this->followSets.assign(count, TerminalBits());
+    for (auto &edge : edges) {
+        edge.clear();
+    }
+    for (size_t r = 0; r < rules.size(); ++r) {
+        for (size_t pos = 0; pos < rhs[r].size(); ++pos) {
+            if (rhs[r][pos] < terminalCount) {
+                continue;
+            }
+            size_t id = rhs[r][pos] - terminalCount;
+            TerminalBits follow = this->suffixFirstSets[r][pos + 1];
+            if (follow.test(nilId)) {
+                follow.reset(nilId);
+                edges[id].push_back(lhs[r]);
+            }
+            this->followSets[id] |= follow;
+        }
+    }
+    if (!rules.empty()) {
+        this->followSets[lhs[0]].set(ParseTable::terminalId(TokenType::TK_EOF));
+    }
+    digraph(this->followSets, edges);
+}
+
+}  // namespace pluma
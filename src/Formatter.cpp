@@ -20,9 +20,17 @@ inline void Formatter::printIndents(const size_t indents) {
     this->out << indentStr;
 }
 
+// What `node`, in the place of a `wrapper` nonterminal that has only unit and
+// nil rules, holds: the wrapper's son, or the node itself if the wrapper was
+// collapsed into it.
+inline const AstNode *unwrap(const AstNode *node, std::string_view wrapper) {
+    auto nt = std::get_if<Nonterminal>(&node->sym);
+    return nt != nullptr && nt->token == wrapper ? node->son : node;
+}
+
 inline bool isStmtCompoundStmt(const AstNode *stmt) {
-    // stmt's son node must be nonterminal.
-    return std::get<Nonterminal>(stmt->son->sym).token == "compound-stmt";
+    auto nt = std::get_if<Nonterminal>(&unwrap(stmt, "stmt")->sym);
+    return nt != nullptr && nt->token == "compound-stmt";
 }
 
 void Formatter::formatNode(const AstNode *nodePtr, const size_t indents) {
@@ -30,16 +38,26 @@ void Formatter::formatNode(const AstNode *nodePtr, const size_t indents) {
         return;
     }
 
+    // A list item the list's unit rule was collapsed into still starts its
+    // own line, as the one-item branch of the list prints it.
+    for (uint64_t path = nodePtr->rulePath; path != 0; path >>= AstNode::rulePathBits) {
+        const std::string &lhs = (*this->rules)[(path & AstNode::rulePathMask) - 1].first.token;
+        if (lhs == "enumerator-list" || lhs == "initializer-list") {
+            printIndents(indents);
+        }
+    }
+
     if (std::holds_alternative<Terminal>(nodePtr->sym)) {
-        // Terminal
-        this->out << nodePtr->sym;
+        // Terminal; its bytes are written straight from the source buffer.
         auto &currToken = std::get<Terminal>(nodePtr->sym).token;
-        if (currToken.comments.size() != 0) {
+        this->out.write(currToken.value.data(), currToken.value.size());
+        if (currToken.index != Token::noIndex) {
             size_t neededIndents = currToken.tokenType == TokenType::LBRACE ? indents + 1 : indents;
-            for (auto comment : std::get<Terminal>(nodePtr->sym).token.comments) {
+            for (const Comment &comment : this->tokens->commentsOf(currToken.index)) {
+                std::string_view text = this->tokens->text(comment);
                 this->out << '\n';
                 printIndents(neededIndents);
-                this->out << comment;
+                this->out.write(text.data(), text.size());
             }
         }
         return;
@@ -180,14 +198,16 @@ void Formatter::formatNode(const AstNode *nodePtr, const size_t indents) {
             AstNode *storage_class_spec_opt = nodePtr->son;
             AstNode *type_qualifier_opt = storage_class_spec_opt->brother;
             AstNode *type_spec = type_qualifier_opt->brother;
+            const AstNode *storage_class_spec = unwrap(storage_class_spec_opt, "storage-class-spec?");
+            const AstNode *type_qualifier = unwrap(type_qualifier_opt, "type-qualifier?");
 
-            if (storage_class_spec_opt->son != nullptr) {
-                formatNode(storage_class_spec_opt->son, indents);
+            if (storage_class_spec != nullptr) {
+                formatNode(storage_class_spec, indents);
                 this->out << ' ';
             }
 
-            if (type_qualifier_opt->son != nullptr) {
-                formatNode(type_qualifier_opt->son, indents);
+            if (type_qualifier != nullptr) {
+                formatNode(type_qualifier, indents);
                 this->out << ' ';
             }
 
@@ -1049,6 +1069,20 @@ void Formatter::formatNode(const AstNode *nodePtr, const size_t indents) {
                     return;
                 }
             }
+        } else if (nt.token == "binary-expr") {
+            // binary-expr ->  operand  operator  operand, built by the
+            // ExprParser
+            AstNode *lhs = nodePtr->son;
+            AstNode *op = lhs->brother;
+            AstNode *rhs = op->brother;
+
+            formatNode(lhs, indents);
+            this->out << ' ';
+
+            formatNode(op, indents);
+            this->out << ' ';
+
+            formatNode(rhs, indents);
         } else if (nt.token == "unary-expr") {
             AstNode *son = nodePtr->son;
             if (std::holds_alternative<Terminal>(son->sym)) {
@@ -1139,7 +1173,9 @@ void Formatter::formatNode(const AstNode *nodePtr, const size_t indents) {
     return;
 }
 
-void Formatter::format(const Ast &ast) {
+void Formatter::format(const Ast &ast, const TokenStream &tokens, const std::vector<Rule> &rules) {
+    this->tokens = &tokens;
+    this->rules = &rules;
     std::cout << std::endl;
     formatNode(ast.head, 0);
     std::cout << std::endl;
@@ -1,5 +1,15 @@
 #include "Grammar.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 namespace pluma {
 
 Action::Action(ActionType type = ActionType::ERROR, size_t state = (size_t)(-1),
@@ -19,112 +29,64 @@ bool Action::operator<(const Action &rhs) const {
     return this->actionType < rhs.actionType;
 }
 
-std::set<Terminal> &Grammar::FIRST(const Sym &sym) {
-    if (std::holds_alternative<Terminal>(sym)) {
-        if (FIRST_SET.find(std::get<Terminal>(sym)) == FIRST_SET.end()) {
-            FIRST_SET[sym] = {std::get<Terminal>(sym)};
-        }
-    }
-    return FIRST_SET[sym];
+const Sym *Grammar::nextSym(const LR1_Item &item) const {
+    auto &rightSyms = ORIGIN_PRODUCE_RULES[item.ruleIndex].second;
+    return item.currPos < rightSyms.size() ? &rightSyms[item.currPos] : nullptr;
 }
 
-std::set<Terminal> &Grammar::FOLLOW(const Sym &sym) { return FOLLOW_SET[sym]; }
-
-std::set<LR1_Item> &Grammar::CLOSURE(const std::set<LR1_Item> &i) {
-    auto result = CLOSURE_SET.find(i);
-    if (result != CLOSURE_SET.end()) {
-        return result->second;
-    }
-
-    std::set<LR1_Item> j = i;
-
-    int prevAddNum = 0, currAddNum = 0;
-    do {
-        prevAddNum = currAddNum;
-        std::set<LR1_Item> added{};
-        for (auto &item : j) {
-            if (!item.isCurrPosAtEnd()) {
-                auto &next = item.rule.second[item.currPos];
-                if (std::holds_alternative<Nonterminal>(next)) {
-                    // only for non-terminal symbol
-                    auto &nextNonterminal = std::get<Nonterminal>(next);
-                    auto &prodRules = PRODUCE_RULES[nextNonterminal];
-                    for (auto &p : prodRules) {
-                        size_t currCurrPos = item.currPos;
-                        bool hasEpsilonProduction = false;
-                        do {
-                            hasEpsilonProduction = false;
-                            ++currCurrPos;
-                            if (currCurrPos < item.rule.second.size()) {
-                                std::set<Terminal> beta_FIRST_Set =
-                                    FIRST(item.rule.second[currCurrPos]);
-                                for (auto &beta : beta_FIRST_Set) {
-                                    if (beta.token.tokenType == TokenType::NIL) {
-                                        hasEpsilonProduction = true;
-                                    } else {
-                                        added.insert(LR1_Item{Rule{nextNonterminal, p}, 0, beta});
-                                    }
-                                }
-                            } else {
-                                added.insert(LR1_Item{Rule{nextNonterminal, p}, 0, item.lookahead});
-                            }
-                        } while (hasEpsilonProduction);
-                    }
-                }
-            }
-        }
-        j.insert(added.begin(), added.end());
-        currAddNum = j.size();
-    } while (currAddNum != prevAddNum);
-
-    // logger << "i:";
-    // for (auto &nt : i) {
-    //     logger << nt << ' ';
-    // }
-    // logger << std::endl;
-
-    // logger << "closure(i) : ";
-    // for (auto &nt : j) {
-    //     logger << nt << ' ';
-    // }
-    // logger << std::endl;
-
-    return CLOSURE_SET[i] = j;
-}
-
-std::set<LR1_Item> &Grammar::LR1_GOTO(const std::set<LR1_Item> &i, const Sym &sym) {
-    std::set<LR1_Item> j;
-    for (auto &item : i) {
-        if (!item.isCurrPosAtEnd() && item.rule.second[item.currPos] == sym) {
-            j.insert(LR1_Item{item.rule, item.currPos + 1, item.lookahead});
+ItemSet Grammar::CLOSURE(const ItemSet &kernel) const {
+    ItemSet j = kernel;
+    // Items that start a rule, by rule; the closure adds only those.
+    std::vector<size_t> itemOfRule(ORIGIN_PRODUCE_RULES.size(), SIZE_MAX);
+    std::vector<size_t> worklist;
+    for (size_t i = 0; i < j.size(); ++i) {
+        if (j[i].currPos == 0) {
+            itemOfRule[j[i].ruleIndex] = i;
         }
+        worklist.push_back(i);
     }
-    return CLOSURE(j);
-}
-
-Action Grammar::LR1_Table_Read(const size_t &state, const Sym &sym) {
-    auto &actionSet = LR1_Table[state][sym];
-    if (actionSet.size() == 0) {
-        // the default constructor makes an error action
-        actionSet.insert(Action{});
-    } else if (actionSet.size() == 2) {
-        for (auto &action : actionSet) {
-            if (action.actionType == Action::ActionType::PUSH_STACK) {
-                return action;
+    // An item is expanded again whenever its lookaheads grow.
+    while (!worklist.empty()) {
+        size_t i = worklist.back();
+        worklist.pop_back();
+        const Sym *next = this->nextSym(j[i]);
+        if (next == nullptr || !std::holds_alternative<Nonterminal>(*next)) {
+            continue;
+        }
+        // only for non-terminal symbol
+        // [A -> a.Bb, L] adds [B -> .c, FIRST(bL)] for every rule of B.
+        TerminalBits lookaheads = firstFollow.suffixFirst(j[i].ruleIndex, j[i].currPos + 1);
+        if (lookaheads.test(FirstFollow::nilId)) {
+            lookaheads.reset(FirstFollow::nilId);
+            lookaheads |= j[i].lookaheads;
+        }
+        auto rules = PRODUCE_RULES.find(std::get<Nonterminal>(*next));
+        if (rules == PRODUCE_RULES.end()) {
+            continue;
+        }
+        for (size_t p : rules->second) {
+            if (itemOfRule[p] == SIZE_MAX) {
+                itemOfRule[p] = j.size();
+                j.push_back(LR1_Item{(uint32_t)p, 0, lookaheads});
+                worklist.push_back(j.size() - 1);
+            } else if ((lookaheads & ~j[itemOfRule[p]].lookaheads).any()) {
+                j[itemOfRule[p]].lookaheads |= lookaheads;
+                worklist.push_back(itemOfRule[p]);
             }
         }
     }
-    return *(actionSet.begin());
+    std::sort(j.begin(), j.end());
+    return j;
 }
 
-Grammar::Grammar(const std::string &grammarFile, const std::string &hashFile,
-                 const std::vector<Rule> &pRule) {
+void Grammar::addRules(const std::vector<Rule> &pRule) {
     // 构造所有产生式
     ORIGIN_PRODUCE_RULES = pRule;
     if (pRule.size()) {
         S = pRule[0].first;
-        for (auto &pl : pRule) {
-            PRODUCE_RULES[pl.first].emplace_back(pl.second);
+        for (size_t i = 0; i < pRule.size(); ++i) {
+            auto &pl = pRule[i];
+            PRODUCE_RULES[pl.first].push_back(i);
             for (auto &sym : pl.second) {
                 if (std::holds_alternative<Terminal>(sym)) {
                     P_TERMINAL_SET.insert(std::get<Terminal>(sym));
@@ -140,474 +102,866 @@ Grammar::Grammar(const std::string &grammarFile, const std::string &hashFile,
             TokenType::TK_EOF,
         },
     });
+}
 
-    size_t symIndex = 0;
+Grammar::Grammar(const std::string &cacheFile, const std::vector<Rule> &pRule,
+                 Construction construction, unsigned threads, const ConflictPolicy &policy)
+    : construction(construction),
+      threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      policy(policy) {
+    this->addRules(pRule);
 
-    for (auto &terminal : P_TERMINAL_SET) {
-        symVec.push_back(terminal);
-        symIndexMap.insert(std::pair{Sym(terminal), symIndex++});
+    uint64_t grammarFingerprint = this->fingerprint();
+    if (!cacheFile.empty() && this->parseTable.load(cacheFile, grammarFingerprint)) {
+        logger << "Parse table mapped from " << cacheFile << ".\n";
+    } else {
+        this->constructTable(pRule, grammarFingerprint);
+        if (!cacheFile.empty() && !this->parseTable.save(cacheFile)) {
+            logger << "Failed to write the parse table cache " << cacheFile << ".\n";
+        }
     }
+    this->compressedTable = CompressedParseTable(this->parseTable);
+}
 
-    for (auto &nonterminal : P_NONTERMINAL_SET) {
-        symVec.push_back(nonterminal);
-        symIndexMap.insert(std::pair{Sym(nonterminal), symIndex++});
+Grammar::Grammar(std::span<const uint64_t> image, const std::vector<Rule> &pRule,
+                 Construction construction, const ConflictPolicy &policy)
+    : construction(construction),
+      threads(std::max(1u, std::thread::hardware_concurrency())),
+      policy(policy) {
+    this->addRules(pRule);
+
+    uint64_t grammarFingerprint = this->fingerprint();
+    if (!this->parseTable.view(image.data(), image.size_bytes(), grammarFingerprint)) {
+        // Only a stale build gets here.
+        logger << "The embedded parse table was built for other rules; rebuilding it.\n";
+        this->constructTable(pRule, grammarFingerprint);
     }
+    this->compressedTable = CompressedParseTable(this->parseTable);
+}
 
-#ifdef HAS_OPENSSL
+void Grammar::constructTable(const std::vector<Rule> &pRule, uint64_t fingerprint) {
+    auto begin = std::chrono::steady_clock::now();
+    this->genLR1Table(pRule);
+    this->resolveConflicts();
+    this->buildParseTable(fingerprint);
+    this->reportConflicts(logger);
+    this->releaseConstructionState();
+    this->stats.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void Grammar::releaseConstructionState() {
+    // Swapped out rather than cleared, so vectors give back their capacity.
+    LR1_TableType().swap(LR1_Table);
+    std::vector<ItemSet>().swap(C_SET);
+    firstFollow = FirstFollow();
+#ifdef __GLIBC__
+    // glibc keeps freed small blocks in its arenas; hand the pages back.
+    malloc_trim(0);
+#endif
+}
 
-    std::string hash = utils::fileHash(grammarFile);
-    std::string hashFromFile;
+uint64_t Grammar::fingerprint() const {
+    // FNV-1a over the construction version, the token numbering and every
+    // rule, symbol by symbol.
+    uint64_t hash = 0xcbf29ce484222325;
+    auto mix = [&hash](std::string_view bytes) {
+        for (char byte : bytes) {
+            hash = (hash ^ (uint8_t)byte) * 0x100000001b3;
+        }
+    };
+    auto mixNumber = [&mix](uint64_t number) {
+        mix(std::string_view((const char *)&number, sizeof(number)));
+    };
 
-    if (utils::loadHashFromFile(hashFile, hashFromFile)) {
-        if (hash == hashFromFile) {
-            this->LR1_Table.clear();
-            bool readLR1TableSuccess = this->readLR1TableFromFile("../../data/lr1_table_cache.txt");
-            if (readLR1TableSuccess) {
-                return;
+    mixNumber(constructionVersion);
+    mixNumber(tokenTypeCount);
+    mixNumber((uint64_t)this->construction);
+    for (auto &rule : ORIGIN_PRODUCE_RULES) {
+        mix(rule.first.token);
+        mixNumber(rule.second.size());
+        for (auto &sym : rule.second) {
+            if (std::holds_alternative<Terminal>(sym)) {
+                mixNumber((uint64_t)(int64_t)std::get<Terminal>(sym).token.tokenType);
             } else {
-                goto failed_to_read;
+                mix(std::get<Nonterminal>(sym).token);
+                mixNumber(UINT64_MAX);
             }
         }
     }
-
-failed_to_read:
-    // Failed to generate hash or read from lr1_table cachefile.
-    this->genLR1Table(pRule);
-    this->writeLR1TableToFile("../../data/lr1_table_cache.txt");
-    utils::saveHashToFile(hashFile, utils::fileHash(grammarFile));
-
-#else
-    this->genLR1Table(pRule);
-#endif
+    for (auto &[type, precedence] : this->policy.terminals) {
+        mixNumber((uint64_t)(int64_t)type);
+        mixNumber((uint64_t)(int64_t)precedence.level);
+        mixNumber((uint64_t)precedence.associativity);
+    }
+    mixNumber(UINT64_MAX);
+    for (auto &[rule, type] : this->policy.rules) {
+        mixNumber(rule);
+        mixNumber((uint64_t)(int64_t)type);
+    }
+    return hash;
 }
 
 void Grammar::genLR1Table(const std::vector<Rule> &pRule) {
-    // 构造FIRST_SET
-    int LAST_FIRST_SIZE = 0;
-    int CURR_FIRST_SIZE = 0;
-    auto CALC_FIRST_SET_COUNT = [&] {
-        size_t SUM = 0;
-        for (auto &fpair : FIRST_SET) {
-            SUM += fpair.second.size();
-        }
-        return SUM;
-    };
-    do {
-        LAST_FIRST_SIZE = CURR_FIRST_SIZE;
-        for (auto &rule : pRule) {
-            auto &leftSym = rule.first;
-            auto &rightSyms = rule.second;
-            for (size_t pIndex = 0; pIndex < rightSyms.size(); ++pIndex) {
-                auto &CURR_FIRST = FIRST(rightSyms[pIndex]);
-                bool hasEpsilonProduction = false;
-                for (auto &sym : CURR_FIRST) {
-                    if (sym.token.tokenType != TokenType::NIL) {
-                        // No epsilon production
-                        FIRST_SET[leftSym].insert(Terminal{sym.token});
-                    } else {
-                        hasEpsilonProduction = true;
-                    }
-                }
-                if (!hasEpsilonProduction) {
-                    break;
-                }
-                if (pIndex + 1 == rightSyms.size()) {
-                    FIRST_SET[leftSym].insert(Terminal{
-                        Token{
-                            "nil",
-                            TokenType::NIL,
-                        },
-                    });
-                }
+    // 构造FIRST_SET, FOLLOW_SET
+    firstFollow = FirstFollow(pRule);
+
+    auto logTerminals = [this](const TerminalBits &terminals) {
+        for (auto &pTerminal : P_TERMINAL_SET) {
+            if (terminals.test(ParseTable::terminalId(pTerminal.token.tokenType))) {
+                logger << " " << pTerminal << " ";
             }
         }
-        CURR_FIRST_SIZE = CALC_FIRST_SET_COUNT();
-    } while (LAST_FIRST_SIZE != CURR_FIRST_SIZE);
-
-    logger << "first set:\n";
-    for (auto &first : FIRST_SET) {
-        logger << "FIRST(" << first.first << ") = ";
-        for (auto &firstSyms : first.second) {
-            logger << " " << firstSyms << " ";
+        if (terminals.test(FirstFollow::nilId)) {
+            logger << " nil ";
         }
         logger << std::endl;
+    };
+    logger << "first set:\n";
+    for (size_t id = 0; id < firstFollow.nonterminals(); ++id) {
+        logger << "FIRST(" << firstFollow.nonterminal(id) << ") = ";
+        logTerminals(firstFollow.first(id));
+    }
+    logger << std::endl;
+    logger << "follow set:\n";
+    for (size_t id = 0; id < firstFollow.nonterminals(); ++id) {
+        logger << "FOLLOW(" << firstFollow.nonterminal(id) << ") = ";
+        logTerminals(firstFollow.follow(id));
     }
     logger << std::endl;
 
-    // 构造FOLLOW_SET
-    FOLLOW_SET[S].insert(Terminal{
-        Token{
-            "",
-            TokenType::TK_EOF,
-        },
-    });
-    int LAST_FOLLOW_SIZE = 0;
-    int CURR_FOLLOW_SIZE = 0;
-    auto CALC_FOLLOW_SET_COUNT = [&] {
-        size_t SUM = 0;
-        for (auto &fpair : FOLLOW_SET) {
-            SUM += fpair.second.size();
-        }
-        return SUM;
+    // 构造LR(1)_Item
+    // [S' -> S, $]
+    TerminalBits eof;
+    eof.set(ParseTable::terminalId(TokenType::TK_EOF));
+    this->genStates({LR1_Item{0, 0, eof}});
+}
+
+namespace {
+
+// Identifies a state by its kernel, the items a GOTO carries over before the
+// closure: two closures are equal exactly when their kernels are. The cores
+// are packed into integers, the lookaheads are left out when only the cores
+// count, and the hash is computed once when the key is built.
+struct KernelKey {
+    std::vector<uint64_t> cores;
+    std::vector<TerminalBits> lookaheads;
+    uint64_t hash;
+
+    KernelKey(const ItemSet &kernel, bool withLookahead) {
+        this->hash = 0xcbf29ce484222325;
+        for (auto &item : kernel) {
+            this->cores.push_back(item.core());
+            this->hash = (this->hash ^ item.core()) * 0x100000001b3;
+            if (withLookahead) {
+                this->lookaheads.push_back(item.lookaheads);
+                this->hash = (this->hash ^ std::hash<TerminalBits>()(item.lookaheads)) *
+                             0x100000001b3;
+            }
+        }
+    }
+
+    bool operator==(const KernelKey &rhs) const {
+        return this->cores == rhs.cores && this->lookaheads == rhs.lookaheads;
+    }
+};
+
+struct KernelKeyHash {
+    size_t operator()(const KernelKey &key) const { return key.hash; }
+};
+
+}  // namespace
+
+struct Grammar::Expansion {
+    std::vector<std::pair<Sym, ItemSet>> gotos;
+    std::vector<KernelKey> keys;
+};
+
+bool Grammar::mergeInto(ItemSet &state, const ItemSet &items) {
+    // Every core of `items` is in `state`, and both are sorted by core.
+    bool grew = false;
+    for (size_t i = 0, k = 0; i < items.size(); ++i) {
+        while (state[k] < items[i]) {
+            ++k;
+        }
+        if ((items[i].lookaheads & ~state[k].lookaheads).any()) {
+            state[k].lookaheads |= items[i].lookaheads;
+            grew = true;
+        }
+    }
+    return grew;
+}
+
+TerminalBits Grammar::reduceConflicts(const ItemSet &kernel) const {
+    // The closure adds items with the dot at the start, which are complete
+    // only for an empty right side, and no rule has one (nil is a symbol):
+    // the kernel holds every reduction of the state.
+    TerminalBits seen, conflicts;
+    for (const LR1_Item &item : kernel) {
+        if (this->nextSym(item) == nullptr) {
+            conflicts |= seen & item.lookaheads;
+            seen |= item.lookaheads;
+        }
+    }
+    return conflicts;
+}
+
+// Calls f(0), ..., f(count - 1) on up to `threads` threads, the caller's
+// included; each index goes to whichever thread is free next.
+template <typename F>
+static void parallelFor(size_t count, unsigned threads, const F &f) {
+    std::atomic<size_t> next = 0;
+    auto work = [&next, count, &f] {
+        for (size_t i = next++; i < count; i = next++) {
+            f(i);
+        }
     };
-    do {
-        LAST_FOLLOW_SIZE = CURR_FOLLOW_SIZE;
-        for (auto &rule : pRule) {
-            auto &leftSym = rule.first;
-            auto &rightSyms = rule.second;
-            for (int pIndex = 0; pIndex < rightSyms.size(); ++pIndex) {
-                const Sym &B = rightSyms[pIndex];
-                if (std::holds_alternative<Nonterminal>(B)) {
-                    // B is Nonterminal
-                    auto &B_FOLLOW_SET = FOLLOW_SET[B];
-                    if (pIndex == rightSyms.size() - 1) {
-                        // A -> aB
-                        auto &A_FOLLOW_SET = FOLLOW_SET[leftSym];
-                        B_FOLLOW_SET.insert(A_FOLLOW_SET.begin(), A_FOLLOW_SET.end());
-                    } else {
-                        // A -> aBb
-                        // succ : B 的后继
-                        const Sym &succ = rightSyms[pIndex + 1];
-                        auto &succ_FIRST_SET = FIRST(succ);
-
-                        bool hasEpsilonProduction = false;
-                        for (auto &terminal : succ_FIRST_SET) {
-                            if (terminal.token.tokenType == TokenType::NIL) {
-                                // b ->* NIL
-                                hasEpsilonProduction = true;
-                            } else {
-                                // b is not NIL
-                                B_FOLLOW_SET.insert(terminal);
-                            }
-                        }
-                        if (hasEpsilonProduction) {
-                            if (pIndex == rightSyms.size() - 2) {
-                                // b 是最后一个
-                                auto &A_FOLLOW_SET = FOLLOW_SET[leftSym];
-                                B_FOLLOW_SET.insert(A_FOLLOW_SET.begin(), A_FOLLOW_SET.end());
-
-                            } else {
-                                // b 并不是最后一个, 找 b 后面的
-                                auto &succ_succ_FOLLOW_SET = FOLLOW_SET[rightSyms[pIndex + 2]];
-                                B_FOLLOW_SET.insert(succ_succ_FOLLOW_SET.begin(),
-                                                    succ_succ_FOLLOW_SET.end());
-                            }
-                        }
+    std::vector<std::thread> workers;
+    for (unsigned k = 1; k < threads && k < count; ++k) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+Grammar::Expansion Grammar::expand(const ItemSet &kernel, bool withLookahead) const {
+    // The kernel of every GOTO out of the state, in one pass; advancing the
+    // dot keeps the items sorted.
+    std::map<Sym, ItemSet> kernels;
+    for (const LR1_Item &item : CLOSURE(kernel)) {
+        if (const Sym *next = this->nextSym(item)) {
+            kernels[*next].push_back(LR1_Item{item.ruleIndex, item.currPos + 1, item.lookaheads});
+        }
+    }
+    Expansion expansion;
+    for (auto &[x, gotoKernel] : kernels) {
+        expansion.keys.emplace_back(gotoKernel, withLookahead);
+        expansion.gotos.emplace_back(x, std::move(gotoKernel));
+    }
+    return expansion;
+}
+
+void Grammar::genStates(const ItemSet &beginKernel) {
+    // LR1 keeps one state per kernel. LALR1 keeps one per core, the kernel
+    // without its lookaheads: a goto set whose core is already a state is
+    // merged into it, and a state that gains lookaheads is processed again so
+    // they reach its successors. Cores pair up across the merged kernels, so a
+    // merge is a union of lookahead bitsets, item by item.
+    // Only kernels are kept; a state's closure lives while it is processed.
+    bool withLookahead = this->construction == Construction::LR1;
+    std::unordered_map<KernelKey, size_t, KernelKeyHash> stateOfKernel;
+    stateOfKernel.emplace(KernelKey(beginKernel, withLookahead), 0);
+    C_SET.assign(1, beginKernel);
+    beginStateIndex = 0;
+
+    // States are processed a frontier at a time, in state order: their
+    // closures and GOTO kernels are computed in parallel, then looked up and
+    // numbered one after another. That visits states in the same order as a
+    // FIFO worklist, so numbering does not depend on the thread count.
+    std::vector<std::map<Sym, size_t>> transitions(1);
+    // grown: merged into since it was last expanded.
+    std::vector<bool> queued{true}, grown{false};
+    std::vector<size_t> frontier{0};
+    while (!frontier.empty()) {
+        std::vector<Expansion> expansions(frontier.size());
+        for (size_t statei : frontier) {
+            grown[statei] = false;
+        }
+        parallelFor(frontier.size(), this->threads, [&](size_t i) {
+            expansions[i] = this->expand(C_SET[frontier[i]], withLookahead);
+        });
+
+        std::vector<size_t> nextFrontier;
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            size_t statei = frontier[i];
+            queued[statei] = false;
+            if (grown[statei]) {
+                // A state earlier in the frontier merged into this one; a
+                // worklist would see the merged kernel here.
+                expansions[i] = this->expand(C_SET[statei], withLookahead);
+            }
+            Expansion &expansion = expansions[i];
+            for (size_t k = 0; k < expansion.gotos.size(); ++k) {
+                auto &[x, kernel] = expansion.gotos[k];
+                auto [found, isNew] = stateOfKernel.emplace(std::move(expansion.keys[k]),
+                                                            C_SET.size());
+                size_t target = found->second;
+                if (isNew) {
+                    C_SET.push_back(std::move(kernel));
+                    transitions.emplace_back();
+                    queued.push_back(true);
+                    grown.push_back(false);
+                    nextFrontier.push_back(target);
+                } else if (!withLookahead && this->mergeInto(C_SET[target], kernel)) {
+                    grown[target] = true;
+                    if (!queued[target]) {
+                        queued[target] = true;
+                        nextFrontier.push_back(target);
                     }
                 }
+                transitions[statei][x] = target;
             }
         }
-        CURR_FOLLOW_SIZE = CALC_FOLLOW_SET_COUNT();
-    } while (LAST_FOLLOW_SIZE != CURR_FOLLOW_SIZE);
+        frontier = std::move(nextFrontier);
+    }
 
-    logger << "follow set:\n";
-    for (auto &follow : FOLLOW_SET) {
-        logger << "FOLLOW(" << follow.first << ") = ";
-        for (auto &followSyms : follow.second) {
-            logger << " " << followSyms << " ";
+    // this->display_LR1_C_SET();
+
+    // 构造LR(1)的语法分析表
+    // The completed items, the only ones that add actions, are gathered in
+    // parallel.
+    std::vector<ItemSet> completed(C_SET.size());
+    parallelFor(C_SET.size(), this->threads, [&](size_t statei) {
+        for (const LR1_Item &item : CLOSURE(C_SET[statei])) {
+            if (this->nextSym(item) == nullptr) {
+                completed[statei].push_back(item);
+            }
+        }
+    });
+    for (size_t statei = 0; statei < C_SET.size(); ++statei) {
+        this->addCompletedItemActions(statei, completed[statei]);
+        for (auto &[next, target] : transitions[statei]) {
+            this->addTransitionAction(statei, next, target);
+        }
+    }
+
+    if (!withLookahead) {
+        this->countMergeConflicts(beginKernel);
+    }
+}
+
+void Grammar::countMergeConflicts(const ItemSet &beginKernel) {
+    // The reduce/reduce cells of the table, by state.
+    std::vector<std::pair<size_t, const Sym *>> cells;
+    for (size_t statei = 0; statei < C_SET.size(); ++statei) {
+        for (auto &[sym, actionSet] : LR1_Table[statei]) {
+            size_t reduces = std::count_if(actionSet.begin(), actionSet.end(), [](auto &action) {
+                return action.actionType == Action::ActionType::REDUCE;
+            });
+            if (reduces >= 2) {
+                cells.emplace_back(statei, &sym);
+            }
+        }
+    }
+    if (cells.empty()) {
+        return;
+    }
+
+    // Merging cores can only add reduce/reduce conflicts. A cell was added by
+    // merging unless a canonical LR(1) state with the same core already
+    // reduces by two rules on its symbol, so the canonical kernels are built
+    // too, keeping only their reduce/reduce lookaheads by core.
+    std::unordered_map<KernelKey, TerminalBits, KernelKeyHash> canonicalConflicts;
+    std::unordered_set<KernelKey, KernelKeyHash> seen{KernelKey(beginKernel, true)};
+    std::vector<ItemSet> pending{beginKernel};
+    while (!pending.empty()) {
+        ItemSet kernel = std::move(pending.back());
+        pending.pop_back();
+        canonicalConflicts[KernelKey(kernel, false)] |= this->reduceConflicts(kernel);
+        Expansion expansion = this->expand(kernel, true);
+        for (size_t k = 0; k < expansion.gotos.size(); ++k) {
+            if (seen.insert(std::move(expansion.keys[k])).second) {
+                pending.push_back(std::move(expansion.gotos[k].second));
+            }
+        }
+    }
+
+    for (auto [statei, sym] : cells) {
+        auto terminal = std::get_if<Terminal>(sym);
+        if (terminal != nullptr &&
+            canonicalConflicts[KernelKey(C_SET[statei], false)].test(
+                ParseTable::terminalId(terminal->token.tokenType))) {
+            continue;
+        }
+        ++this->stats.mergeConflicts;
+        logger << "LALR(1) merge conflict in state " << statei << ", symbol " << *sym << ":";
+        for (auto &action : LR1_Table[statei][*sym]) {
+            logger << " R" << action.state;
         }
         logger << std::endl;
     }
-    logger << std::endl;
+}
 
-    // 构造LR(1)_Item
-    auto LR1_Item_Set_Equal = [](const std::set<LR1_Item> &s1,
-                                 const std::set<LR1_Item> &s2) -> bool {
-        if (s1.size() != s2.size()) {
-            return false;
+void Grammar::addCompletedItemActions(size_t statei, const ItemSet &state) {
+    for (const LR1_Item &prod : state) {
+        if (this->nextSym(prod) != nullptr) {
+            continue;
+        }
+        auto &rule = ORIGIN_PRODUCE_RULES[prod.ruleIndex];
+        if (rule.first == S) {
+            // S' -> S, 完成
+            Terminal eof{
+                Token{
+                    "",
+                    TokenType::TK_EOF,
+                },
+            };
+            LR1_Table[statei][eof].insert(Action{Action::ActionType::ACCEPT, (size_t)10000, eof});
+            continue;
         }
-        for (auto s1Iter = s1.begin(), s2Iter = s2.begin();
-             s1Iter != s1.end() && s2Iter != s2.end(); ++s1Iter, ++s2Iter) {
-            if ((*s1Iter) != (*s2Iter)) {
-                return false;
+        for (auto &pTerminal : P_TERMINAL_SET) {
+            if (prod.lookaheads.test(ParseTable::terminalId(pTerminal.token.tokenType))) {
+                LR1_Table[statei][pTerminal].insert(
+                    Action{Action::ActionType::REDUCE, prod.ruleIndex, pTerminal});
             }
         }
-        return true;
+    }
+}
+
+void Grammar::addTransitionAction(size_t statei, const Sym &next, size_t target) {
+    auto type = std::holds_alternative<Nonterminal>(next) ? Action::ActionType::GOTO
+                                                          : Action::ActionType::PUSH_STACK;
+    LR1_Table[statei][next].insert(Action{type, target,
+                                          Terminal{
+                                              Token{
+                                                  "nil",
+                                                  TokenType::NIL,
+                                              },
+                                          }});
+}
+
+const ConflictPolicy::Precedence *Grammar::rulePrecedence(size_t rule) const {
+    auto precedenceOf = [this](TokenType type) -> const ConflictPolicy::Precedence * {
+        auto found = this->policy.terminals.find(type);
+        return found != this->policy.terminals.end() ? &found->second : nullptr;
     };
-    // [S' -> S, $]
-    auto beginState = CLOSURE({LR1_Item{
-        pRule[0],
-        0,
-        Token{
-            "",
-            TokenType::TK_EOF,
-        },
-    }});
-    std::set<std::set<LR1_Item>> C{beginState};
-    bool increased = false;
-    do {
-        increased = false;
-
-        for (const std::set<LR1_Item> &itemSet : C) {
-            std::vector<std::set<LR1_Item>> newAddToC;
-            std::set<Sym> nextSym;
-            for (const LR1_Item &item : itemSet) {
-                if (!item.isCurrPosAtEnd()) {
-                    nextSym.insert(item.rule.second[item.currPos]);
-                }
+    if (auto named = this->policy.rules.find(rule); named != this->policy.rules.end()) {
+        return precedenceOf(named->second);
+    }
+    auto &rightSyms = ORIGIN_PRODUCE_RULES[rule].second;
+    for (auto sym = rightSyms.rbegin(); sym != rightSyms.rend(); ++sym) {
+        if (auto terminal = std::get_if<Terminal>(&*sym)) {
+            if (auto precedence = precedenceOf(terminal->token.tokenType)) {
+                return precedence;
             }
-            for (const Sym &x : nextSym) {
-                auto &iset = LR1_GOTO(itemSet, x);
+        }
+    }
+    return nullptr;
+}
 
-                if (!iset.empty() && C.find(iset) == C.end()) {
-                    newAddToC.push_back(iset);
-                    increased = true;
-                }
+void Grammar::resolveConflicts() {
+    this->conflicts.clear();
+    for (auto &[state, row] : LR1_Table) {
+        for (auto cell = row.begin(); cell != row.end();) {
+            auto &[sym, actionSet] = *cell;
+            if (actionSet.size() < 2) {
+                ++cell;
+                continue;
             }
-            for (auto &newSet : newAddToC) {
-                C.insert(newSet);
+            // The set is ordered by type, then target: the lowest rule is
+            // the first reduction.
+            const Action *shift = nullptr;
+            const Action *reduce = nullptr;
+            for (auto &action : actionSet) {
+                if (action.actionType == Action::ActionType::PUSH_STACK) {
+                    shift = &action;
+                } else if (action.actionType == Action::ActionType::REDUCE && !reduce) {
+                    reduce = &action;
+                }
             }
-        }
-
-    } while (increased);
-    C_SET = C;
-
-    // this->display_LR1_C_SET();
 
-    // 构造LR(1)的语法分析表
-    std::map<size_t, std::map<Sym, std::set<Action>, SymLess>> &lr1_Table = LR1_Table;
-    for (size_t statei = 0; auto &state : C) {
-        std::set<Sym> nextSet;
-        for (const LR1_Item &prod : state) {
-            if (prod.isCurrPosAtEnd()) {
-                if (prod.rule.first == pRule[0].first) {
-                    // S' -> S, 完成
-                    lr1_Table[statei][Terminal{
-                                          Token{
-                                              "",
-                                              TokenType::TK_EOF,
-                                          },
-                                      }]
-                        .insert(Action{Action::ActionType::ACCEPT, (size_t)10000, prod.lookahead});
+            Conflict conflict{state, sym, {actionSet.begin(), actionSet.end()},
+                              *actionSet.begin(), "lowest rule"};
+            if (shift && reduce) {
+                auto lookahead = this->policy.terminals.find(
+                    std::get<Terminal>(sym).token.tokenType);
+                const ConflictPolicy::Precedence *rule = this->rulePrecedence(reduce->state);
+                if (rule == nullptr || lookahead == this->policy.terminals.end()) {
+                    conflict.chosen = *shift;
+                    conflict.reason = "shift by default";
+                } else if (rule->level != lookahead->second.level) {
+                    conflict.chosen = rule->level > lookahead->second.level ? *reduce : *shift;
+                    conflict.reason = "precedence";
                 } else {
-                    size_t originIndex = (size_t)(std::find(ORIGIN_PRODUCE_RULES.begin(),
-                                                            ORIGIN_PRODUCE_RULES.end(), prod.rule) -
-                                                  ORIGIN_PRODUCE_RULES.begin());
-                    for (auto &pTerminal : P_TERMINAL_SET) {
-                        if (pTerminal == prod.lookahead) {
-                            lr1_Table[statei][pTerminal].insert(
-                                Action{Action::ActionType::REDUCE, originIndex, prod.lookahead});
+                    switch (lookahead->second.associativity) {
+                        case ConflictPolicy::Associativity::LEFT: {
+                            conflict.chosen = *reduce;
+                            conflict.reason = "left associative";
+                            break;
+                        }
+                        case ConflictPolicy::Associativity::RIGHT: {
+                            conflict.chosen = *shift;
+                            conflict.reason = "right associative";
+                            break;
+                        }
+                        case ConflictPolicy::Associativity::NONASSOC: {
+                            conflict.chosen = Action{Action::ActionType::ERROR, (size_t)(-1),
+                                                     Terminal{Token{}}};
+                            conflict.reason = "nonassociative";
+                            break;
                         }
                     }
                 }
+            } else if (reduce) {
+                conflict.chosen = *reduce;
+            }
+
+            actionSet.clear();
+            if (conflict.chosen.actionType == Action::ActionType::ERROR) {
+                cell = row.erase(cell);
             } else {
-                nextSet.insert(prod.rule.second[prod.currPos]);
-            }
-        }
-        for (auto &next : nextSet) {
-            const auto &nextState = LR1_GOTO(state, next);
-            for (size_t j = 0; auto &IJ : C) {
-                if (IJ == nextState) {
-                    if (std::holds_alternative<Nonterminal>(next)) {
-                        LR1_Table[statei][next].insert(Action{Action::ActionType::GOTO, j,
-                                                              Terminal{
-                                                                  Token{
-                                                                      "nil",
-                                                                      TokenType::NIL,
-                                                                  },
-                                                              }});
-                    } else {
-                        LR1_Table[statei][next].insert(Action{Action::ActionType::PUSH_STACK, j,
-                                                              Terminal{
-                                                                  Token{
-                                                                      "nil",
-                                                                      TokenType::NIL,
-                                                                  },
-                                                              }});
-                    }
-                }
-                ++j;
+                actionSet.insert(conflict.chosen);
+                ++cell;
             }
+            this->conflicts.push_back(std::move(conflict));
         }
-        ++statei;
     }
-    for (size_t statei = 0; auto &state : C_SET) {
-        if (state == beginState) {
-            beginStateIndex = statei;
+    this->stats.conflicts = this->conflicts.size();
+}
+
+void Grammar::reportConflicts(std::ostream &os) const {
+    if (this->conflicts.empty()) {
+        return;
+    }
+    auto actionName = [](const Action &action) -> std::string {
+        switch (action.actionType) {
+            case Action::ActionType::PUSH_STACK:
+                return "S" + std::to_string(action.state);
+            case Action::ActionType::REDUCE:
+                return "R" + std::to_string(action.state);
+            case Action::ActionType::ACCEPT:
+                return "A";
+            case Action::ActionType::GOTO:
+                return "G" + std::to_string(action.state);
+            case Action::ActionType::ERROR:
+                return "E";
+        }
+        return "";
+    };
+    os << this->conflicts.size() << " conflicts, resolved:\n";
+    for (auto &conflict : this->conflicts) {
+        os << "In state " << conflict.state << ", symbol " << conflict.sym << ":";
+        for (auto &action : conflict.actions) {
+            os << " " << actionName(action);
         }
-        ++statei;
+        os << " -> " << actionName(conflict.chosen) << " (" << conflict.reason << ")\n";
     }
+    os << std::endl;
 }
 
-void Grammar::writeLR1TableToFile(std::string filename) {
-    // Open the file or create it if not exist.
-    std::fstream file;
-    file.open(filename, std::ios::out);
-    if (!file.is_open()) {
-        file.clear();
-        file.open(filename, std::ios::out);
-        file.close();
-        file.open(filename);
+void Grammar::buildParseTable(uint64_t fingerprint) {
+    // Dense ids of the GOTO columns.
+    std::map<Nonterminal, size_t> nonterminalIds;
+    for (auto &nonterminal : P_NONTERMINAL_SET) {
+        nonterminalIds.emplace(nonterminal, nonterminalIds.size());
+    }
+    // The augmented start symbol is never reduced, but its rule needs an id.
+    nonterminalIds.emplace(S, nonterminalIds.size());
+
+    this->parseTable = ParseTable(fingerprint, C_SET.size(), nonterminalIds.size(),
+                                  ORIGIN_PRODUCE_RULES.size(), this->beginStateIndex);
+
+    for (size_t i = 0; i < ORIGIN_PRODUCE_RULES.size(); ++i) {
+        auto &rule = ORIGIN_PRODUCE_RULES[i];
+        this->parseTable.setRule(i, nonterminalIds.at(rule.first), rule.second.size());
     }
-    file.sync_with_stdio(false);
 
-    for (auto &statePair : LR1_Table) {
-        file << statePair.first << '\n';
-        for (auto &symPair : statePair.second) {
-            file << symIndexMap[symPair.first] << ' ';
-            for (auto &action : symPair.second) {
-                file << (size_t)action.actionType << ' ' << action.state << ' ';
+    for (auto &[state, row] : LR1_Table) {
+        for (auto &[sym, actionSet] : row) {
+            if (actionSet.empty()) {
+                continue;
+            }
+            // resolveConflicts() has left one action per cell.
+            const Action *chosen = &*actionSet.begin();
+            switch (chosen->actionType) {
+                case Action::ActionType::GOTO: {
+                    this->parseTable.setGoto(
+                        state, nonterminalIds.at(std::get<Nonterminal>(sym)), chosen->state);
+                    break;
+                }
+                case Action::ActionType::PUSH_STACK: {
+                    this->parseTable.setAction(state, std::get<Terminal>(sym).token.tokenType,
+                                               ParseTable::Kind::PUSH_STACK, chosen->state);
+                    break;
+                }
+                case Action::ActionType::REDUCE: {
+                    this->parseTable.setAction(state, std::get<Terminal>(sym).token.tokenType,
+                                               ParseTable::Kind::REDUCE, chosen->state);
+                    break;
+                }
+                case Action::ActionType::ACCEPT: {
+                    this->parseTable.setAction(state, std::get<Terminal>(sym).token.tokenType,
+                                               ParseTable::Kind::ACCEPT, 0);
+                    break;
+                }
+                case Action::ActionType::ERROR: {
+                    break;
+                }
             }
-            file << -1 << ' ' << -1 << '\n';
         }
-        file << -1 << '\n';
     }
-    file << -2 << '\n';
-
-    file << this->beginStateIndex << '\n';
-
-    // Close the file.
-    file.close();
 }
 
-bool Grammar::readLR1TableFromFile(std::string filename) {
-    std::ifstream file;
-    file.open(filename, std::ios::in);
-    if (!file.is_open()) {
-        logger << "Failed to read from cache file.\n";
-        return false;
-    }
-    file.sync_with_stdio(false);
-    while (!file.eof()) {
-        int32_t state_i32 = 0;
-        file >> state_i32;
-        while (state_i32 != -2) {
-            size_t state = (size_t)state_i32;
-            int32_t symIndex_i32 = 0;
-            file >> symIndex_i32;
-            while (symIndex_i32 != -1) {
-                size_t symIndex = (size_t)symIndex_i32;
-                int32_t actionType_i32, toState_i32;
-                file >> actionType_i32 >> toState_i32;
-                while (actionType_i32 != -1) {
-                    size_t actionType = (size_t)actionType_i32;
-                    size_t toState = (size_t)toState_i32;
-                    this->LR1_Table[state][symVec[symIndex]].insert(Action{
-                        (Action::ActionType)actionType,
-                        toState,
-                    });
-                    file >> actionType_i32 >> toState_i32;
+void Grammar::setExpressionParser(const ExprParser *parser) {
+    this->exprParser = parser;
+    this->exprStarts.clear();
+    this->exprGoto.clear();
+    if (parser == nullptr) {
+        return;
+    }
+    const ParseTable &table = this->parseTable;
+    size_t expr = SIZE_MAX;
+    for (size_t i = 0; i < ORIGIN_PRODUCE_RULES.size(); ++i) {
+        if (ORIGIN_PRODUCE_RULES[i].first.token == parser->nonterminal()) {
+            expr = table.ruleLhs(i);
+        }
+    }
+    if (expr == SIZE_MAX) {
+        this->exprParser = nullptr;
+        return;
+    }
+
+    // After the shift on an operand or a unary operator, the state must
+    // reduce it by one rule of length one whatever follows (an identifier
+    // may also open a call); after the shift on '(', '++' or '--', which open
+    // longer constructs, it must not reduce at all. A state that could read the
+    // token as a declarator, a type or a label fails both.
+    auto onlyExpression = [&table](size_t target, TokenType type, bool operand) {
+        size_t reduction = SIZE_MAX;
+        for (int next = TokenType::TK_EOF; next + 1 < (int)tokenTypeCount; ++next) {
+            ParseTable::Word action = table.action(target, (TokenType)next);
+            switch (ParseTable::kindOf(action)) {
+                case ParseTable::Kind::REDUCE: {
+                    size_t rule = ParseTable::targetOf(action);
+                    if (!operand || table.ruleLength(rule) != 1 ||
+                        (reduction != SIZE_MAX && reduction != rule)) {
+                        return false;
+                    }
+                    reduction = rule;
+                    break;
+                }
+                case ParseTable::Kind::PUSH_STACK: {
+                    if (operand && !(type == TokenType::IDENTIFIER && next == TokenType::LPAREN)) {
+                        return false;
+                    }
+                    break;
+                }
+                case ParseTable::Kind::ACCEPT: {
+                    return false;
+                }
+                case ParseTable::Kind::ERROR: {
+                    break;
                 }
-                file >> symIndex_i32;
             }
-            file >> state_i32;
         }
-        if (state_i32 == -2) {
-            break;
+        return !operand || reduction != SIZE_MAX;
+    };
+
+    this->exprStarts.resize(table.states());
+    this->exprGoto.assign(table.states(), ParseTable::noState);
+    for (size_t state = 0; state < table.states(); ++state) {
+        ParseTable::Word target = table.gotoState(state, expr);
+        if (target == ParseTable::noState) {
+            continue;
+        }
+        for (int type = TokenType::TK_EOF; type + 1 < (int)tokenTypeCount; ++type) {
+            ParseTable::Word action = table.action(state, (TokenType)type);
+            if (!parser->startsExpression((TokenType)type) ||
+                ParseTable::kindOf(action) != ParseTable::Kind::PUSH_STACK) {
+                continue;
+            }
+            bool operand = type != TokenType::LPAREN && type != TokenType::INCR &&
+                           type != TokenType::DECR;
+            if (onlyExpression(ParseTable::targetOf(action), (TokenType)type, operand)) {
+                this->exprStarts[state].set(ParseTable::terminalId((TokenType)type));
+                this->exprGoto[state] = target;
+            }
         }
     }
+}
 
-    file >> this->beginStateIndex;
+void Grammar::setUnitCollapsing(bool collapse) {
+    this->unitRules.clear();
+    this->unitStates.clear();
+    // A rule index plus one must fit in a slot of the rule path.
+    if (!collapse || ORIGIN_PRODUCE_RULES.size() >= AstNode::rulePathMask) {
+        return;
+    }
+    this->unitRules.resize(ORIGIN_PRODUCE_RULES.size());
+    for (size_t i = 0; i < ORIGIN_PRODUCE_RULES.size(); ++i) {
+        const SymList &right = ORIGIN_PRODUCE_RULES[i].second;
+        if (right.size() != 1) {
+            continue;
+        }
+        // A nil right side leaves no node to collapse into.
+        auto terminal = std::get_if<Terminal>(&right.front());
+        this->unitRules[i] = terminal == nullptr || terminal->token.tokenType != TokenType::NIL;
+    }
 
-    file.close();
-    return true;
+    // A state passes through if every lookahead, by its own action or the
+    // state's default, reduces by the same unit rule.
+    const CompressedParseTable &table = this->compressedTable;
+    this->unitStates.assign(table.states(), noRule);
+    for (size_t state = 0; state < table.states(); ++state) {
+        size_t rule = SIZE_MAX;
+        for (int type = TokenType::TK_EOF; type + 1 < (int)tokenTypeCount; ++type) {
+            ParseTable::Word action = table.action(state, (TokenType)type);
+            if (ParseTable::kindOf(action) == ParseTable::Kind::ERROR) {
+                action = table.epsilonAction(state);
+            }
+            if (ParseTable::kindOf(action) != ParseTable::Kind::REDUCE ||
+                !this->unitRules[ParseTable::targetOf(action)] ||
+                (rule != SIZE_MAX && rule != ParseTable::targetOf(action))) {
+                rule = SIZE_MAX;
+                break;
+            }
+            rule = ParseTable::targetOf(action);
+        }
+        if (rule != SIZE_MAX) {
+            this->unitStates[state] = (uint32_t)rule;
+        }
+    }
 }
 
-Ast Grammar::gen(std::vector<Sym> str) {
-    if (str.empty()) {
+Ast Grammar::gen(const TokenStream &tokens) {
+    if (tokens.empty()) {
         logger << "\nsource file is empty\n\n";
         return Ast(nullptr);
     }
-    std::vector<size_t> stateStack;
-    std::vector<AstNode *> nodeStack;
+    const CompressedParseTable &table = this->compressedTable;
+    // The stacks keep their capacity from one parse to the next; a parse
+    // rarely nests deeper than it has tokens.
+    std::vector<ParseTable::Word> &stateStack = this->stateStack;
+    std::vector<AstNode *> &nodeStack = this->nodeStack;
+    stateStack.clear();
+    nodeStack.clear();
+    stateStack.reserve(tokens.size() + 1);
+    nodeStack.reserve(tokens.size() + 1);
     size_t strPos = 0;
-    stateStack.push_back(beginStateIndex);
+    this->parseStats = ParseStats();
+    stateStack.push_back((ParseTable::Word)table.startState());
     while (1) {
-        Sym currSym = str[strPos];
         size_t state = stateStack.back();
 
-        const auto &action = LR1_Table_Read(state, currSym);
-        const auto &epsilonAction = LR1_Table_Read(state, Terminal{Token{"nil", TokenType::NIL}});
-        if (action.actionType != Action::ActionType::ERROR ||
-            epsilonAction.actionType != Action::ActionType::ERROR) {
-            bool isRuleEpsilon = false;
-            if (action.actionType == Action::ActionType::ERROR) {
+        if (this->exprParser != nullptr &&
+            this->exprStarts[state].test(ParseTable::terminalId(tokens.type(strPos)))) {
+            if (AstNode *expr = this->exprParser->parse(tokens, strPos)) {
+                stateStack.push_back(this->exprGoto[state]);
+                nodeStack.push_back(expr);
+                ++this->parseStats.exprHandoffs;
+                continue;
+            }
+        }
+
+        ParseTable::Word action;
+        bool isRuleEpsilon = false;
+        if (!this->unitStates.empty() && this->unitStates[state] != noRule) {
+            // Reduces by the rule whatever the lookahead.
+            action = ParseTable::pack(ParseTable::Kind::REDUCE, this->unitStates[state]);
+        } else {
+            action = table.action(state, tokens.type(strPos));
+            if (ParseTable::kindOf(action) == ParseTable::Kind::ERROR) {
+                action = table.epsilonAction(state);
                 isRuleEpsilon = true;
             }
-            auto &takenAction = isRuleEpsilon ? epsilonAction : action;
-            logger << "Current state : " << state << ", symbol : " << currSym << std::endl;
-            logger << "Current action : " << (int)takenAction.actionType << " " << takenAction.state
+        }
+        size_t target = ParseTable::targetOf(action);
+        if (this->trace && ParseTable::kindOf(action) != ParseTable::Kind::ERROR) {
+            logger << "Current state : " << state << ", symbol : " << tokens.text(strPos)
                    << std::endl;
-            switch (takenAction.actionType) {
-                case Action::ActionType::REDUCE: {
-                    auto &rule = ORIGIN_PRODUCE_RULES[action.state];
-                    // Left symbol
-                    auto leftSymNode = (AstNode *)new AstNode(rule.first);
-                    std::vector<AstNode *> rev;
-                    for (size_t i = 0; i < rule.second.size(); ++i) {
-                        stateStack.pop_back();
-                        rev.push_back(nodeStack.back());
-                        nodeStack.pop_back();
-                    }
-                    for (size_t i = 0; i < rule.second.size(); ++i) {
-                        leftSymNode->appendSon(rev.back());
-                        rev.pop_back();
-                    }
-
-                    // GOTO
-                    const auto &gotoAction = LR1_Table_Read(stateStack.back(), rule.first);
-                    if (gotoAction.actionType == Action::ActionType::GOTO) {
-                        stateStack.push_back(gotoAction.state);
-                    } else {
+            logger << "Current action : " << (int)ParseTable::kindOf(action) << " " << target
+                   << std::endl;
+        }
+        switch (ParseTable::kindOf(action)) {
+            case ParseTable::Kind::REDUCE: {
+                if (!this->unitRules.empty() && this->unitRules[target] &&
+                    nodeStack.back()->canCollapse()) {
+                    // The node on top stands for the left symbol as well;
+                    // only the state changes.
+                    nodeStack.back()->collapse(target);
+                    stateStack.pop_back();
+                    ParseTable::Word gotoState =
+                        table.gotoState(stateStack.back(), table.ruleLhs(target));
+                    if (gotoState == ParseTable::noState) {
                         goto error;
                     }
-                    nodeStack.push_back(leftSymNode);
+                    stateStack.push_back(gotoState);
+                    ++this->parseStats.unitCollapses;
 
-                    logger << rule;
-                    break;
-                }
-                case Action::ActionType::PUSH_STACK: {
-                    stateStack.push_back(takenAction.state);
-                    if (isRuleEpsilon) {
-                        nodeStack.push_back(nullptr);
-                    } else {
-                        nodeStack.push_back((AstNode *)new AstNode(str[strPos++]));
+                    if (this->trace) {
+                        logger << ORIGIN_PRODUCE_RULES[target];
                     }
                     break;
                 }
-                case Action::ActionType::GOTO: {
-                    // This branch shouldn't be accessed.
-                    break;
+
+                // GOTO from the state under the right side, looked up first so
+                // that nothing is allocated on the way to the error.
+                size_t length = table.ruleLength(target);
+                ParseTable::Word gotoState = table.gotoState(
+                    stateStack[stateStack.size() - 1 - length], table.ruleLhs(target));
+                if (gotoState == ParseTable::noState) {
+                    goto error;
                 }
-                case Action::ActionType::ACCEPT: {
-                    logger << "\nFinished parse procedure.\n";
-                    AstNode *headPtr = nodeStack.back();
-                    nodeStack.pop_back();
-                    if (nodeStack.size()) {
-                        // Not an AST-tree.
-                        logger << "\nNot an ast-tree!\n";
-                        goto err_failed_to_recover;
-                    }
-                    return Ast(headPtr);
+
+                // Left symbol; the right side is the top of the node stack,
+                // in order.
+                auto leftSymNode = (AstNode *)new AstNode(ORIGIN_PRODUCE_RULES[target].first);
+                for (size_t i = nodeStack.size() - length; i < nodeStack.size(); ++i) {
+                    leftSymNode->appendSon(nodeStack[i]);
                 }
-                case Action::ActionType::ERROR: {
-                    goto error;
+                nodeStack.resize(nodeStack.size() - length);
+                stateStack.resize(stateStack.size() - length);
+                stateStack.push_back(gotoState);
+                nodeStack.push_back(leftSymNode);
+                ++this->parseStats.reductions;
+
+                if (this->trace) {
+                    logger << ORIGIN_PRODUCE_RULES[target];
                 }
+                break;
             }
-        } else {
-        error:
-            std::cerr << "\nERROR: state " << state << ", symbol " << currSym
-                      << " have an error action.\n";
-            std::cerr << "At line " << std::get<Terminal>(currSym).token.line << ":";
-            std::vector<Terminal> shouldBe;
-            if (LR1_Table.find(state) != LR1_Table.end()) {
-                for (auto &actionList : LR1_Table.at(state)) {
-                    if (std::holds_alternative<Terminal>(actionList.first) &&
-                        actionList.second.size() == 1 &&
-                        actionList.second.begin()->actionType != Action::ActionType::ERROR) {
-                        shouldBe.push_back(std::get<Terminal>(actionList.first));
-                    }
+            case ParseTable::Kind::PUSH_STACK: {
+                stateStack.push_back((ParseTable::Word)target);
+                ++this->parseStats.shifts;
+                if (isRuleEpsilon) {
+                    nodeStack.push_back(nullptr);
+                } else {
+                    nodeStack.push_back((AstNode *)new AstNode(Terminal{tokens.token(strPos)}));
+                    ++strPos;
                 }
+                break;
             }
-            if (shouldBe.size()) {
-                for (auto &expectedTerminal : shouldBe) {
-                    std::cerr << expectedTerminal << " expected.\n";
-                    break;
+            case ParseTable::Kind::ACCEPT: {
+                if (this->trace) {
+                    logger << "\nFinished parse procedure.\n";
                 }
+                AstNode *headPtr = nodeStack.back();
+                nodeStack.pop_back();
+                if (nodeStack.size()) {
+                    // Not an AST-tree.
+                    logger << "\nNot an ast-tree!\n";
+                    goto err_failed_to_recover;
+                }
+                return Ast(headPtr);
+            }
+            case ParseTable::Kind::ERROR: {
+            error:
+                // EOF has no text of its own.
+                std::cerr << "\nERROR: state " << state << ", symbol "
+                          << (tokens.type(strPos) == TokenType::TK_EOF ? "<eof>"
+                                                                       : tokens.text(strPos))
+                          << " have an error action.\n";
+                utils::SourcePosition position = tokens.position(strPos);
+                std::cerr << "At line " << position.line << ", column " << position.column << ":";
+                // The first terminal the state can act on.
+                for (int type = TokenType::TK_EOF; type + 1 < (int)tokenTypeCount; ++type) {
+                    if (ParseTable::kindOf(table.action(state, (TokenType)type)) !=
+                        ParseTable::Kind::ERROR) {
+                        auto expected = P_TERMINAL_SET.find(Terminal{Token{"", (TokenType)type}});
+                        if (type == TokenType::TK_EOF) {
+                            std::cerr << "<eof> expected.\n";
+                        } else if (expected != P_TERMINAL_SET.end()) {
+                            std::cerr << *expected << " expected.\n";
+                        }
+                        break;
+                    }
+                }
+                std::cerr << std::endl;
+                // TODO: error recovery
+                goto err_failed_to_recover;
             }
-            std::cerr << std::endl;
-            // TODO: error recovery
-            goto err_failed_to_recover;
         }
     }
 
@@ -615,32 +969,6 @@ err_failed_to_recover:
     return Ast(nullptr);
 }
 
-bool Grammar::checkLR1() {
-    bool result = false;
-    for (auto &state : LR1_Table) {
-        size_t stateIndex = state.first;
-        for (auto &symCol : state.second) {
-            const Sym &sym = symCol.first;
-            std::set<Action> &actionSet = symCol.second;
-            if (actionSet.size() >= 2) {
-                if (!result) {
-                    logger << "LR1 has grammatical conflict:\n\n\n";
-                    result = true;
-                }
-                logger << "In state " << stateIndex << ", symbol " << sym << std::endl;
-                for (auto &action : actionSet) {
-                    if (action.actionType == Action::ActionType::REDUCE)
-                        logger << "R" << action.state << std::endl;
-                    else if (action.actionType == Action::ActionType::PUSH_STACK)
-                        logger << "S" << action.state << std::endl;
-                }
-                logger << std::endl << std::endl;
-            }
-        }
-    }
-    return result;
-}
-
 void Grammar::display_LR1_Table() {
     for (auto &state : LR1_Table) {
         size_t stateIndex = state.first;
@@ -684,19 +1012,31 @@ void Grammar::display_LR1_Table() {
     }
 }
 
-std::ostream &operator<<(std::ostream &os, const std::set<LR1_Item> itemSet) {
-    for (auto &item : itemSet) {
-        os << item;
-    }
-    return os;
-}
-
 void Grammar::display_LR1_C_SET() {
     for (size_t i = 0; auto &state : C_SET) {
         logger << "===============\n";
         logger << "state " << i << ":\n";
         logger << "---------------\n";
-        logger << state;
+        for (auto &item : state) {
+            auto &rule = ORIGIN_PRODUCE_RULES[item.ruleIndex];
+            logger << rule.first << " -> ";
+            for (size_t pos = 0; pos < rule.second.size(); ++pos) {
+                if (item.currPos == pos) {
+                    logger << " . ";
+                }
+                logger << " " << rule.second[pos] << " ";
+            }
+            if (item.currPos == rule.second.size()) {
+                logger << " . ";
+            }
+            logger << ",";
+            for (auto &pTerminal : P_TERMINAL_SET) {
+                if (item.lookaheads.test(ParseTable::terminalId(pTerminal.token.tokenType))) {
+                    logger << " " << pTerminal;
+                }
+            }
+            logger << std::endl;
+        }
         logger << "===============\n";
         ++i;
     }
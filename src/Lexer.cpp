@@ -1,554 +1,433 @@
 #include "Lexer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "LexerDfa.hpp"
+#include "utils/LineIndex.h"
+#include "utils/Simd.h"
+
 namespace pluma {
 
 Lexer::Lexer(std::string inputFilename) {
-    this->inputFile.open(inputFilename);
-
-    if (!this->inputFile.is_open()) {
+    auto buffer = std::make_shared<utils::SourceBuffer>();
+    if (!buffer->open(inputFilename)) {
         std::cerr << "Cannot open input file.\n";
         exit(EXIT_FAILURE);
     }
+    this->source = std::move(buffer);
+    this->cursor = this->source->begin();
+    this->end = this->source->end();
 }
 
-Lexer::~Lexer() { this->inputFile.close(); }
+Lexer::Lexer(std::shared_ptr<const utils::SourceBuffer> source) : source(std::move(source)) {
+    this->cursor = this->source->begin();
+    this->end = this->source->end();
+}
 
-// Get a char; if the next character is the expected one, return it;
-// else unget and return 0.
-char expectChar(std::fstream &file, char expectedChar) {
-    char actualChar = file.get();
-    if (actualChar == expectedChar) {
-        return actualChar;
-    } else if (actualChar == -1) {
-        return -1;
-    } else {
-        file.unget();
-        return 0;
-    }
+Lexer::Lexer(std::shared_ptr<const utils::SourceBuffer> source, const char *begin,
+             bool speculative)
+    : source(std::move(source)), cursor(begin), speculative(speculative) {
+    this->end = this->source->end();
 }
 
-Token Lexer::scan(std::fstream &file) {
-    if (file.eof()) {
+Token Lexer::lexError(const char *what) {
+    if (speculative) {
+        // A worker that started in the middle of a comment or literal can hit
+        // errors the real lexer never sees; stop and let the stitcher decide.
+        failed = true;
+        cursor = end;
         return Token();
     }
+    // Lines are not tracked while scanning; find the position only now.
+    utils::SourcePosition position = utils::LineIndex(source->begin(), source->end())
+                                         .position(cursor - source->begin());
+    char errmsg[127];
+    snprintf(errmsg, sizeof(errmsg), "At line %zu, column %zu:\n%s\n", position.line,
+             position.column, what);
+    panic(errmsg);
+    return Token();
+}
 
-    while (!file.eof()) {
-        // Skip blank character.
-        for (; isblank(peek) || peek == '\n'; peek = file.get()) {
-            if (peek == '\n') {
-                ++line;
-            }
-        }
-        if (file.eof()) {
-            return Token();
-        }
-
-        {
-            std::string value = "";
-            switch (peek) {
-                case '+': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '+');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::INCR, line);
-                    }
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::ADD_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::ADD, line);
-                    break;
-                }
-                case '-': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '-');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::DECR, line);
-                    }
-                    peek = expectChar(file, '>');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::ARROW, line);
-                    }
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::SUB_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::SUB, line);
-                    break;
-                }
-                case '*': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::MUL_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::MUL, line);
-                    break;
-                }
-                case '/': {
-                    value.push_back(peek);
-
-                    // "/="
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::DIV_ASSIGN, line);
-                    }
-
-                    // "//"
-                    peek = expectChar(file, '/');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        while ((peek = file.get()) != '\n') {
-                            value.push_back(peek);
-                        }
-                        peek = file.get();
-                        return Token(value, TokenType::LINE_COMMENT, line);
-                    }
-
-                    // "/* */"
-                    peek = expectChar(file, '*');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        for (peek = file.get(); peek != -1 && peek != '*'; peek = file.get()) {
-                            value.push_back(peek);
-                            if (peek == '\n') {
-                                ++line;
-                            }
-                        }
-                        switch (peek) {
-                            case -1: {
-                                char errmsg[63];
-                                sprintf(errmsg,
-                                        "At line %d:\n"
-                                        "Block comment doesn't close.\n",
-                                        line);
-                                panic(errmsg);
-                                return Token();
-                                break;
-                            }
-                            case '*': {
-                                value.push_back(peek);
-                                peek = expectChar(file, '/');
-                                if (peek && peek != -1) {
-                                    value.push_back(peek);
-                                    peek = file.get();
-                                    return Token(value, TokenType::BLOCK_COMMENT, line);
-                                } else {
-                                    char errmsg[63];
-                                    sprintf(errmsg,
-                                            "At line %d:\n"
-                                            "Block comment doesn't close.\n",
-                                            line);
-                                    panic(errmsg);
-                                    return Token();
-                                    break;
-                                }
-                            }
-                        }
-                    }
-
-                    // "/"
-                    peek = file.get();
-                    return Token(value, TokenType::DIV, line);
-                    break;
-                }
-                case '%': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::MOD_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::MOD, line);
-                    break;
-                }
-                case '&': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '&');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::AND, line);
-                    }
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::BITAND_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::BITAND, line);
-                    break;
-                }
-                case '|': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '|');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::OR, line);
-                    }
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::BITOR_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::BITOR, line);
-                    break;
-                }
-                case '^': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::BITXOR_ASSIGN, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::BITXOR, line);
-                    break;
-                }
-                case '<': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '<');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = expectChar(file, '=');
-                        if (peek && peek != -1) {
-                            value.push_back(peek);
-                            peek = file.get();
-                            return Token(value, TokenType::LSHIFT_ASSIGN, line);
-                        }
-                        peek = file.get();
-                        return Token(value, TokenType::LSHIFT, line);
-                    }
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::LE, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::LT);
-                }
-                case '>': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '>');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = expectChar(file, '=');
-                        if (peek && peek != -1) {
-                            value.push_back(peek);
-                            peek = file.get();
-                            return Token(value, TokenType::RSHIFT_ASSIGN, line);
-                        }
-                        peek = file.get();
-                        return Token(value, TokenType::RSHIFT, line);
-                    }
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::GE, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::GT, line);
-                }
-                case '=': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::EQ, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::ASSIGN, line);
-                    break;
-                }
-                case '~': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::BITNOT, line);
-                }
-                case '!': {
-                    value.push_back(peek);
-                    peek = expectChar(file, '=');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::NEQ, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::NOT, line);
-                }
+void Lexer::utf8Error(const char *at) {
+    this->cursor = at;
+    char errmsg[63];
+    snprintf(errmsg, sizeof(errmsg), "Invalid UTF-8 byte 0x%02x.", (unsigned char)*at);
+    lexError(errmsg);
+}
 
-                // Brackets.
-                case '(': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::LPAREN, line);
-                }
-                case ')': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::RPAREN, line);
-                }
-                case '[': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::LSBRACKET, line);
-                }
-                case ']': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::RSBRACKET, line);
-                }
-                case '{': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::LBRACE, line);
-                }
-                case '}': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::RBRACE, line);
-                }
+inline bool isIdentifierHead(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
 
-                case ',': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::COMMA, line);
-                }
-                case '.': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    // Check if the successor is a digit.
-                    if (!isdigit(peek)) {
-                        return Token(value, TokenType::PERIOD, line);
-                    } else {
-                        // If the successor is a digit, recover from the status
-                        // before and break.
-                        value.pop_back();
-                        file.unget();
-                        peek = '.';
-                        break;
-                    }
-                }
-                case ':': {
-                    value.push_back(peek);
-                    peek = expectChar(file, ':');
-                    if (peek && peek != -1) {
-                        value.push_back(peek);
-                        peek = file.get();
-                        return Token(value, TokenType::DBL_COLON, line);
-                    }
-                    peek = file.get();
-                    return Token(value, TokenType::COLON, line);
-                }
-                case ';': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::SEMICOLON, line);
-                }
-                case '?': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::QUESTION_MARK, line);
-                }
+inline bool isDigitChar(char c) { return c >= '0' && c <= '9'; }
 
-                case '#': {
-                    value.push_back(peek);
-                    peek = file.get();
-                    return Token(value, TokenType::SHARP, line);
-                }
+// Scans the mapped input as a raw byte range: no per-character stream calls
+// and no get()/unget() round-trips. Lexemes are cut out of the buffer in one
+// piece, the long runs (blanks, identifiers, comments, strings) are skipped
+// by the vector kernels in utils/Simd.h, and operators go through the table
+// DFA in LexerDfa.hpp.
+Token Lexer::scan() {
+    // Skip blank characters.
+    cursor = utils::skipBlanks(cursor, end);
+    if (cursor == end) {
+        return Token();
+    }
 
-                default:
-                    break;
-            }
+    const char *start = cursor;
+    auto expect = [this](char expectedChar) {
+        if (cursor < end && *cursor == expectedChar) {
+            ++cursor;
+            return true;
         }
+        return false;
+    };
+    auto make = [&](TokenType type) {
+        return Token(std::string_view(start, cursor - start), type);
+    };
 
-        // Handle keywords and identifiers.
-        if (isalpha(peek) || peek == '_') {
-            std::string value = "";
+    // Operators, punctuators and comment openers, longest match first.
+    TokenType type;
+    cursor = lexer_dfa::match(start, end, type);
+    switch (type) {
+        case TokenType::UNKNOWN:
+            break;
 
-            do {
-                value.push_back(peek);
-                peek = file.get();
-            } while (isalpha(peek) || isdigit(peek) || peek == '_');
+        // "//"
+        case TokenType::LINE_COMMENT: {
+            auto newline = (const char *)memchr(cursor, '\n', end - cursor);
+            cursor = newline != nullptr ? newline : end;
+            return make(TokenType::LINE_COMMENT);
+        }
 
-            if (auto token_pair = keywordMap.find(value); token_pair != keywordMap.end()) {
-                return Token(token_pair->first, token_pair->second, line);
-            } else if (auto token_pair = preprocessorMap.find(value);
-                       token_pair != preprocessorMap.end()) {
-                return Token(token_pair->first, token_pair->second, line);
+        // "/* */"
+        case TokenType::BLOCK_COMMENT: {
+            cursor = utils::findBlockCommentEnd(cursor, end);
+            if (cursor == end) {
+                return lexError("Block comment doesn't close.");
             }
-
-            return Token(value, TokenType::IDENTIFIER, line);
+            cursor += 2;
+            return make(TokenType::BLOCK_COMMENT);
         }
 
-        // Handle C-style string constant.
-        if (peek == '\"') {
-            std::string value = "";
-            value.push_back(peek);
-            while ((peek = file.get()) != '\"') {
-                if (file.eof() || peek == '\n') {
-                    char errmsg[63];
-                    sprintf(errmsg,
-                            "At line %d:\n"
-                            "String constant doesn't close.\n",
-                            line);
-                    panic(errmsg);
-                    return Token();
-                }
-                value.push_back(peek);
+        case TokenType::PERIOD: {
+            // A digit after the period makes it a float constant.
+            if (cursor == end || !isDigitChar(*cursor)) {
+                return make(TokenType::PERIOD);
             }
-            value.push_back(peek);
-            peek = file.get();
-            return Token(value, TokenType::STRING_CONST, line);
+            break;
         }
 
-        // Handle character constant.
-        if (peek == '\'') {
-            std::string value = "";
+        default:
+            return make(type);
+    }
+    cursor = start;
+    char c = *cursor;
 
-            value.push_back(peek);
+    // Handle keywords and identifiers.
+    if (isIdentifierHead(c)) {
+        cursor = utils::skipIdentifier(cursor + 1, end);
 
-            peek = expectChar(file, '\\');
-            if (peek && peek != -1) {
-                value.push_back(peek);
-            }
-            peek = file.get();
-            if (!isascii(peek)) {
-                char errmsg[63];
-                sprintf(errmsg,
-                        "At line %d:\n"
-                        "Character constant includes non-ascii character!\n",
-                        line);
-                panic(errmsg);
-                return Token();
+        return make(lookupKeyword(std::string_view(start, cursor - start)));
+    }
+
+    // Handle C-style string constant.
+    if (c == '\"') {
+        for (++cursor;;) {
+            cursor = utils::findStringSpecial(cursor, end);
+            if (cursor == end || *cursor == '\n') {
+                return lexError("String constant doesn't close.");
             }
-            value.push_back(peek);
-            peek = expectChar(file, '\'');
-            if (!peek) {
-                char errmsg[127];
-                sprintf(errmsg,
-                        "At line %d:\n"
-                        "Quotation mark doesn't close, or there are more than "
-                        "1 character in the char constant.\n",
-                        line);
-                panic(errmsg);
-                return Token();
+            if (*cursor == '\"') {
+                break;
             }
-            value.push_back(peek);
-            peek = file.get();
-            return Token(value, TokenType::CHAR_CONST, line);
+            // Escaped character, e.g. "\"".
+            cursor += (cursor + 1 < end && cursor[1] != '\n') ? 2 : 1;
         }
+        ++cursor;
+        return make(TokenType::STRING_CONST);
+    }
+
+    // Handle character constant.
+    if (c == '\'') {
+        ++cursor;
+        expect('\\');
+        if (cursor == end || !isascii(*cursor)) {
+            return lexError("Character constant includes non-ascii character!");
+        }
+        ++cursor;
+        if (!expect('\'')) {
+            return lexError(
+                "Quotation mark doesn't close, or there are more than "
+                "1 character in the char constant.");
+        }
+        return make(TokenType::CHAR_CONST);
+    }
+
+    // Handle numbers.
+    if (isDigitChar(c) || c == '.') {
+        bool isFloat = (c == '.');
+        bool isHex = false;
 
-        // Handle numbers.
-        if (isdigit(peek) || peek == '.') {
-            std::string value = "";
-            bool isFloat = (peek == '.') ? true : false;
-            bool isHex = false;
-
-            value.push_back(peek);
-
-            while ((peek = file.get())) {
-                if (isdigit(peek)) {
-                } else if (peek == '.') {
-                    if (isFloat) {
-                        char errmsg[63];
-                        sprintf(errmsg,
-                                "At line %d:\n"
-                                "Character \'.\' appears twice in a float.\n",
-                                line);
-                        panic(errmsg);
-                    }
-                    isFloat = true;
-                } else if (peek == 'x' || peek == 'X') {
-                    if (value.length() != 1 || value[0] != '0') {
-                        char errmsg[63];
-                        sprintf(errmsg,
-                                "At line %d:\n"
-                                "Wrong character appeared in a number\n",
-                                line);
-                        panic(errmsg);
-                    }
-                    isHex = true;
-                } else if (isalpha(peek)) {
-                    if (!(isHex &&
-                          ((peek >= 'a' && peek <= 'f') || (peek >= 'A' && peek <= 'F')))) {
-                        char errmsg[63];
-                        sprintf(errmsg,
-                                "At line %d:\n"
-                                "Wrong character appeared in a number\n",
-                                line);
-                        panic(errmsg);
-                    }
-                } else {
-                    break;
+        for (++cursor; cursor < end; ++cursor) {
+            char p = *cursor;
+            if (isDigitChar(p)) {
+            } else if (p == '.') {
+                if (isFloat) {
+                    return lexError("Character \'.\' appears twice in a float.");
                 }
-                value.push_back(peek);
-            }
-            if (isFloat) {
-                if (isHex) {
-                    char errmsg[63];
-                    sprintf(errmsg,
-                            "At line %d:\n"
-                            "Wrong character appeared in a number\n",
-                            line);
-                    panic(errmsg);
-                    return Token();
+                isFloat = true;
+            } else if (p == 'x' || p == 'X') {
+                if (cursor - start != 1 || *start != '0') {
+                    return lexError("Wrong character appeared in a number");
+                }
+                isHex = true;
+            } else if (isIdentifierHead(p) && p != '_') {
+                if (!(isHex && ((p >= 'a' && p <= 'f') || (p >= 'A' && p <= 'F')))) {
+                    return lexError("Wrong character appeared in a number");
                 }
-                return Token(value, TokenType::FLOAT_CONST, line);
             } else {
-                return Token(value, TokenType::INT_CONST, line);
+                break;
             }
         }
+        if (isFloat && isHex) {
+            return lexError("Wrong character appeared in a number");
+        }
+        return make(isFloat ? TokenType::FLOAT_CONST : TokenType::INT_CONST);
+    }
+
+    char errmsg[63];
+    snprintf(errmsg, sizeof(errmsg), "Unexpected character '\\x%02x'.", (unsigned char)c);
+    return lexError(errmsg);
+}
+
+// Comments go to the comment table of the token before them.
+static void pushLexeme(TokenStream &tokens, TokenType type, const char *begin, const char *end) {
+    if (type != TokenType::BLOCK_COMMENT && type != TokenType::LINE_COMMENT) {
+        tokens.push(type, begin, end);
+    } else {
+        tokens.pushComment(begin, end);
     }
-    return Token();
 }
 
-std::vector<pluma::Sym> Lexer::tokenize() {
-    std::vector<pluma::Sym> symVec;
-    while (!this->inputFile.eof()) {
-        pluma::Token token = this->scan(this->inputFile);
+TokenStream Lexer::tokenize() {
+    if (const char *invalid = utils::validateUtf8(this->cursor, this->end);
+        invalid != this->end) {
+        this->utf8Error(invalid);
+    }
+    TokenStream tokens(this->source);
+    while (this->cursor < this->end) {
+        pluma::Token token = this->scan();
         if (token.tokenType != pluma::TokenType::UNKNOWN) {
-            if (token.tokenType != TokenType::BLOCK_COMMENT &&
-                token.tokenType != TokenType::LINE_COMMENT) {
-                symVec.push_back(pluma::Terminal{token});
-            } else {
-                auto prevNoncommentSymIter = symVec.rbegin();
-                if (prevNoncommentSymIter != symVec.rend()) {
-                    // A comment belongs to its previous token.
-                    std::get<Terminal>(*prevNoncommentSymIter).token.comments.push_back(token);
+            const char *begin = token.value.data();
+            pushLexeme(tokens, token.tokenType, begin, begin + token.value.size());
+        }
+    }
+    tokens.push(TokenType::TK_EOF, this->end, this->end);
+    return tokens;
+}
+
+namespace {
+
+// Below this many bytes per worker, threads cost more than they save.
+constexpr size_t minChunkSize = 256 * 1024;
+
+// A token or comment found by a chunk worker.
+struct Lexeme {
+    TokenType type;
+    uint32_t offset;
+    uint32_t length;
+};
+
+}  // namespace
+
+struct Lexer::Chunk {
+    const char *begin;
+    const char *end;
+    // Lexemes starting in [begin, end), in order.
+    std::vector<Lexeme> lexemes;
+    // Lexer position after the last lexeme.
+    const char *resume;
+    // First ill-formed UTF-8 sequence in [begin, end), or `end`.
+    const char *invalid;
+};
+
+void Lexer::lexChunk(Chunk &chunk) {
+    chunk.resume = cursor;
+    while (cursor < chunk.end) {
+        Token token = scan();
+        // The last lexeme may run past the chunk end; one that starts past it
+        // belongs to the next chunk.
+        if (failed || token.tokenType == TokenType::UNKNOWN || token.value.data() >= chunk.end) {
+            break;
+        }
+        chunk.lexemes.push_back(Lexeme{
+            token.tokenType,
+            (uint32_t)(token.value.data() - source->data()),
+            (uint32_t)token.value.size(),
+        });
+        chunk.resume = cursor;
+    }
+}
+
+TokenStream Lexer::tokenizeParallel(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t chunkCount = std::min<size_t>(threads, (end - cursor) / minChunkSize);
+    if (chunkCount <= 1 || source->size() > UINT32_MAX) {
+        return tokenize();
+    }
+
+    // Cut at line starts: a chunk then begins inside a token only if the token
+    // spans lines, which only block comments can.
+    std::vector<Chunk> chunks(chunkCount);
+    const char *begin = cursor;
+    for (size_t k = 0; k < chunkCount; ++k) {
+        chunks[k].begin = k == 0 ? begin : chunks[k - 1].end;
+        const char *target = begin + (end - begin) * (k + 1) / chunkCount;
+        if (k + 1 == chunkCount) {
+            chunks[k].end = end;
+        } else if (target <= chunks[k].begin) {
+            chunks[k].end = chunks[k].begin;
+        } else {
+            auto newline = (const char *)memchr(target, '\n', end - target);
+            chunks[k].end = newline != nullptr ? newline + 1 : end;
+        }
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t k = 0; k < chunkCount; ++k) {
+        workers.emplace_back([this, &chunks, k] {
+            Chunk &chunk = chunks[k];
+            chunk.invalid = utils::validateUtf8(chunk.begin, chunk.end);
+            Lexer worker(source, chunk.begin, true);
+            worker.lexChunk(chunk);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (auto &chunk : chunks) {
+        if (chunk.invalid != chunk.end) {
+            this->utf8Error(chunk.invalid);
+        }
+    }
+
+    // Stitch: lex sequentially until a real token starts where some chunk has
+    // a lexeme, take the rest of that chunk as is (lexing is a function of the
+    // position only), and continue sequentially from where the chunk stopped.
+    TokenStream tokens(source);
+    Lexer stitcher(source, begin, false);
+    size_t k = 0;
+    while (stitcher.cursor < stitcher.end) {
+        Token token = stitcher.scan();
+        if (token.tokenType == TokenType::UNKNOWN) {
+            break;
+        }
+        const char *start = token.value.data();
+        while (k < chunkCount && start >= chunks[k].end) {
+            ++k;
+        }
+        if (k < chunkCount) {
+            Chunk &chunk = chunks[k];
+            auto offset = (uint32_t)(start - source->data());
+            auto match = std::lower_bound(
+                chunk.lexemes.begin(), chunk.lexemes.end(), offset,
+                [](const Lexeme &lexeme, uint32_t offset) { return lexeme.offset < offset; });
+            if (match != chunk.lexemes.end() && match->offset == offset) {
+                for (; match != chunk.lexemes.end(); ++match) {
+                    const char *lexemeBegin = source->data() + match->offset;
+                    pushLexeme(tokens, match->type, lexemeBegin, lexemeBegin + match->length);
                 }
+                stitcher.cursor = chunk.resume;
+                ++k;
+                continue;
+            }
+        }
+        pushLexeme(tokens, token.tokenType, start, start + token.value.size());
+    }
+    this->cursor = this->end;
+    tokens.push(TokenType::TK_EOF, this->end, this->end);
+    return tokens;
+}
+
+void Lexer::relex(TokenStream &tokens, const TextEdit &edit) {
+    const utils::SourceBuffer &oldBuffer = tokens.buffer();
+    if (edit.offset + edit.removed > oldBuffer.size()) {
+        panic("Edit range is outside the input.");
+    }
+    std::vector<char> bytes;
+    bytes.reserve(oldBuffer.size() - edit.removed + edit.inserted.size());
+    bytes.insert(bytes.end(), oldBuffer.begin(), oldBuffer.begin() + edit.offset);
+    bytes.insert(bytes.end(), edit.inserted.begin(), edit.inserted.end());
+    bytes.insert(bytes.end(), oldBuffer.begin() + edit.offset + edit.removed, oldBuffer.end());
+    auto source = std::make_shared<const utils::SourceBuffer>(std::move(bytes));
+
+    // The old text was valid, so only characters touching the edit can be
+    // broken: check from the last character starting before it through the
+    // end of the inserted text and any continuation bytes after it.
+    const char *checkBegin = source->begin() + (edit.offset >= 3 ? edit.offset - 3 : 0);
+    const char *checkEnd = source->begin() + edit.offset + edit.inserted.size();
+    while (checkBegin > source->begin() && ((uint8_t)*checkBegin & 0xC0) == 0x80) {
+        --checkBegin;
+    }
+    while (checkEnd < source->end() && ((uint8_t)*checkEnd & 0xC0) == 0x80) {
+        ++checkEnd;
+    }
+    if (const char *invalid = utils::validateUtf8(checkBegin, checkEnd); invalid != checkEnd) {
+        Lexer(source).utf8Error(invalid);
+    }
+
+    // Restart at the last token that ends before the edit: scanning it (and
+    // deciding where it ends) reads at most one byte past its end, so it and
+    // everything before it are unchanged.
+    size_t oldCount = tokens.size() - 1;  // without EOF
+    size_t low = 0, high = oldCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if ((size_t)tokens.offset(mid) + tokens.length(mid) < edit.offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    size_t restart = low == 0 ? 0 : low - 1;
+
+    TokenStream relexed(source);
+    Lexer lexer(source, source->begin() + (low > 0 ? tokens.offset(restart) : 0), false);
+
+    // Old tokens that start at or after the end of the removed range are
+    // candidates to line up with; in the new text they sit `delta` later.
+    int64_t delta = (int64_t)edit.inserted.size() - (int64_t)edit.removed;
+    size_t editEnd = edit.offset + edit.inserted.size();
+    size_t candidate = restart;
+    while (lexer.cursor < lexer.end) {
+        Token token = lexer.scan();
+        if (token.tokenType == TokenType::UNKNOWN) {
+            break;
+        }
+        const char *begin = token.value.data();
+        auto offset = (size_t)(begin - source->data());
+        if (offset >= editEnd) {
+            auto oldOffset = (size_t)((int64_t)offset - delta);
+            while (candidate < oldCount && tokens.offset(candidate) < oldOffset) {
+                ++candidate;
+            }
+            // Lexing depends on the position only, so from here on the old
+            // tokens are the new ones.
+            if (candidate < oldCount && tokens.offset(candidate) == oldOffset &&
+                oldOffset >= edit.offset + edit.removed) {
+                tokens.splice(restart, candidate, relexed, delta);
+                return;
             }
         }
+        pushLexeme(relexed, token.tokenType, begin, begin + token.value.size());
     }
-    symVec.push_back(pluma::Terminal{pluma::Token{"EOF", pluma::TokenType::TK_EOF}});
-    return symVec;
+    relexed.push(TokenType::TK_EOF, lexer.end, lexer.end);
+    tokens.splice(restart, tokens.size(), relexed, 0);
 }
 
-}  // namespace pluma
\ No newline at end of file
+}  // namespace pluma
@@ -0,0 +1,107 @@
+#include "ParseTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "main.h"
+
+namespace pluma {
+
+static constexpr char parseTableMagic[8] = {'P', 'L', 'U', 'M', 'A', 'L', 'R', '\n'};
+
+size_t ParseTable::imageSize(size_t stateCount, size_t nonterminalCount, size_t ruleCount) {
+    size_t words = stateCount * (terminalCount + nonterminalCount) + 2 * ruleCount;
+    return sizeof(ParseTableHeader) + words * sizeof(Word);
+}
+
+void ParseTable::attach(const ParseTableHeader *header) {
+    this->header = header;
+    this->actions = (const Word *)(header + 1);
+    this->gotos = this->actions + (size_t)header->stateCount * terminalCount;
+    this->lhs = this->gotos + (size_t)header->stateCount * header->nonterminalCount;
+    this->lengths = this->lhs + header->ruleCount;
+}
+
+ParseTable::ParseTable(uint64_t fingerprint, size_t stateCount, size_t nonterminalCount,
+                       size_t ruleCount, size_t beginState) {
+    if (stateCount > maxTarget || ruleCount > maxTarget) {
+        panic("Parse table: too many states or rules for a 16-bit cell.");
+    }
+    size_t size = imageSize(stateCount, nonterminalCount, ruleCount);
+    this->owned.assign((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+
+    auto *header = (ParseTableHeader *)this->owned.data();
+    memcpy(header->magic, parseTableMagic, sizeof(parseTableMagic));
+    header->fingerprint = fingerprint;
+    header->version = formatVersion;
+    header->stateCount = (uint32_t)stateCount;
+    header->terminalCount = (uint32_t)terminalCount;
+    header->nonterminalCount = (uint32_t)nonterminalCount;
+    header->ruleCount = (uint32_t)ruleCount;
+    header->beginState = (uint32_t)beginState;
+    this->attach(header);
+
+    std::fill_n(this->writable(this->actions), stateCount * terminalCount, pack(Kind::ERROR, 0));
+    std::fill_n(this->writable(this->gotos), stateCount * nonterminalCount, noState);
+}
+
+void ParseTable::setAction(size_t state, TokenType type, Kind kind, size_t target) {
+    *this->writable(this->actions + state * terminalCount + terminalId(type)) = pack(kind, target);
+}
+
+void ParseTable::setGoto(size_t state, size_t nonterminal, size_t target) {
+    *this->writable(this->gotos + state * this->header->nonterminalCount + nonterminal) =
+        (Word)target;
+}
+
+void ParseTable::setRule(size_t rule, size_t lhsNonterminal, size_t length) {
+    *this->writable(this->lhs + rule) = (Word)lhsNonterminal;
+    *this->writable(this->lengths + rule) = (Word)length;
+}
+
+bool ParseTable::save(const std::string &filename) const {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write((const char *)this->header, this->memoryUsage());
+    return (bool)file;
+}
+
+bool ParseTable::load(const std::string &filename, uint64_t fingerprint) {
+    auto buffer = std::make_unique<utils::SourceBuffer>();
+    if (!buffer->open(filename) || !this->view(buffer->data(), buffer->size(), fingerprint)) {
+        return false;
+    }
+    this->mapped = std::move(buffer);
+    return true;
+}
+
+bool ParseTable::view(const void *image, size_t size, uint64_t fingerprint) {
+    if (size < sizeof(ParseTableHeader)) {
+        return false;
+    }
+    auto *header = (const ParseTableHeader *)image;
+    if (memcmp(header->magic, parseTableMagic, sizeof(parseTableMagic)) != 0 ||
+        header->version != formatVersion || header->fingerprint != fingerprint ||
+        header->terminalCount != terminalCount || header->beginState >= header->stateCount) {
+        return false;
+    }
+    // Embedded images are padded to whole 64-bit words.
+    size_t expected = imageSize(header->stateCount, header->nonterminalCount, header->ruleCount);
+    if (size < expected || size - expected >= sizeof(uint64_t)) {
+        return false;
+    }
+    this->owned.clear();
+    this->mapped.reset();
+    this->attach(header);
+    return true;
+}
+
+size_t ParseTable::memoryUsage() const {
+    return imageSize(this->header->stateCount, this->header->nonterminalCount,
+                     this->header->ruleCount);
+}
+
+}  // namespace pluma
@@ -2,45 +2,10 @@
 
 namespace pluma {
 
-Token::Token() : value(std::string("")), tokenType(TokenType::UNKNOWN) {}
+Token::Token() : value(), tokenType(TokenType::UNKNOWN), index(noIndex) {}
 
-Token::Token(std::string _value, TokenType _type, size_t _line, std::vector<Token> _comments)
-    : value(_value), tokenType(_type), line(_line), comments(_comments) {}
-
-Token::Token(const Token &other) {
-    this->value = other.value;
-    this->tokenType = other.tokenType;
-    this->line = other.line;
-    this->comments = other.comments;
-}
-
-Token::Token(Token &&other)
-    : value(std::move(other.value)),
-      tokenType(other.tokenType),
-      line(other.line),
-      comments(std::move(other.comments)) {}
-
-Token &Token::operator=(const Token &other) {
-    if (this == &other) {
-        return *this;
-    }
-    this->value = other.value;
-    this->tokenType = other.tokenType;
-    this->line = other.line;
-    this->comments = other.comments;
-    return *this;
-}
-
-Token &Token::operator=(Token &&other) {
-    if (this == &other) {
-        return *this;
-    }
-    this->value = std::move(other.value);
-    this->tokenType = other.tokenType;
-    this->line = other.line;
-    this->comments = std::move(other.comments);
-    return *this;
-}
+Token::Token(std::string_view _value, TokenType _type, uint32_t _index)
+    : value(_value), tokenType(_type), index(_index) {}
 
 std::ostream &operator<<(std::ostream &os, const Sym &sym) {
     if (std::holds_alternative<Nonterminal>(sym)) {
@@ -0,0 +1,110 @@
+#include "TokenStream.h"
+
+#include <algorithm>
+
+#include "main.h"
+
+namespace pluma {
+
+TokenStream::TokenStream(std::shared_ptr<const utils::SourceBuffer> source)
+    : source(std::move(source)) {
+    if (this->source->size() > UINT32_MAX) {
+        panic("Input files larger than 4 GiB are not supported.");
+    }
+}
+
+void TokenStream::push(TokenType type, const char *begin, const char *end) {
+    this->types.push_back((uint8_t)(int8_t)type);
+    this->offsets.push_back((uint32_t)(begin - this->source->data()));
+    this->lengths.push_back((uint32_t)(end - begin));
+}
+
+void TokenStream::pushComment(const char *begin, const char *end) {
+    if (this->types.empty()) {
+        return;
+    }
+    this->comments.push_back(Comment{
+        (uint32_t)(this->types.size() - 1),
+        (uint32_t)(begin - this->source->data()),
+        (uint32_t)(end - begin),
+    });
+}
+
+template <typename T>
+static void replaceRange(std::vector<T> &target, size_t first, size_t last,
+                         const std::vector<T> &source) {
+    size_t common = std::min(last - first, source.size());
+    std::copy(source.begin(), source.begin() + common, target.begin() + first);
+    if (common < source.size()) {
+        target.insert(target.begin() + last, source.begin() + common, source.end());
+    } else {
+        target.erase(target.begin() + first + common, target.begin() + last);
+    }
+}
+
+void TokenStream::splice(size_t first, size_t last, const TokenStream &replacement,
+                         int64_t offsetDelta) {
+    auto byIndex = [](const Comment &comment, size_t index) { return comment.tokenIndex < index; };
+    auto commentFirst =
+        std::lower_bound(this->comments.begin(), this->comments.end(), first, byIndex) -
+        this->comments.begin();
+    auto commentLast =
+        std::lower_bound(this->comments.begin(), this->comments.end(), last, byIndex) -
+        this->comments.begin();
+
+    replaceRange(this->types, first, last, replacement.types);
+    replaceRange(this->offsets, first, last, replacement.offsets);
+    replaceRange(this->lengths, first, last, replacement.lengths);
+    replaceRange(this->comments, commentFirst, commentLast, replacement.comments);
+
+    size_t tail = first + replacement.size();
+    for (size_t i = tail; i < this->types.size(); ++i) {
+        this->offsets[i] = (uint32_t)(this->offsets[i] + offsetDelta);
+    }
+    size_t commentTail = commentFirst + replacement.comments.size();
+    for (size_t i = commentFirst; i < commentTail; ++i) {
+        this->comments[i].tokenIndex += (uint32_t)first;
+    }
+    auto indexDelta = (int64_t)replacement.size() - (int64_t)(last - first);
+    for (size_t i = commentTail; i < this->comments.size(); ++i) {
+        Comment &comment = this->comments[i];
+        comment.tokenIndex = (uint32_t)(comment.tokenIndex + indexDelta);
+        comment.offset = (uint32_t)(comment.offset + offsetDelta);
+    }
+    this->source = replacement.source;
+    this->lineIndex.reset();
+}
+
+Token TokenStream::token(size_t i) const {
+    if (this->type(i) == TokenType::TK_EOF) {
+        return Token("EOF", TokenType::TK_EOF, (uint32_t)i);
+    }
+    return Token(this->text(i), this->type(i), (uint32_t)i);
+}
+
+const utils::LineIndex &TokenStream::lines() const {
+    if (this->lineIndex == nullptr) {
+        this->lineIndex =
+            std::make_shared<const utils::LineIndex>(this->source->begin(), this->source->end());
+    }
+    return *this->lineIndex;
+}
+
+std::span<const Comment> TokenStream::commentsOf(size_t i) const {
+    auto first = std::lower_bound(
+        this->comments.begin(), this->comments.end(), i,
+        [](const Comment &comment, size_t index) { return comment.tokenIndex < index; });
+    auto last = first;
+    while (last != this->comments.end() && last->tokenIndex == i) {
+        ++last;
+    }
+    return std::span<const Comment>(first, last);
+}
+
+size_t TokenStream::memoryUsage() const {
+    return this->types.capacity() * sizeof(uint8_t) + this->offsets.capacity() * sizeof(uint32_t) +
+           this->lengths.capacity() * sizeof(uint32_t) +
+           this->comments.capacity() * sizeof(Comment);
+}
+
+}  // namespace pluma
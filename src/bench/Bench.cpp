@@ -0,0 +1,169 @@
+#include "bench/Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "TokenStream.h"
+
+void panic(const char *info) {
+    std::cerr << "\nError: " << info << std::endl;
+    std::abort();
+}
+
+namespace pluma {
+
+namespace bench {
+
+std::string scaleInput(const std::string &filename, size_t repeat) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Cannot open input file.\n";
+        exit(EXIT_FAILURE);
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string content = ss.str();
+
+    auto path = std::filesystem::temp_directory_path() / "pluma_bench_input.c";
+    std::ofstream out(path, std::ios::binary);
+    for (size_t i = 0; i < repeat; ++i) {
+        out << content;
+        if (!content.empty() && content.back() != '\n') {
+            out << '\n';
+        }
+    }
+    return path.string();
+}
+
+std::string scaleProgram(const std::string &filename, size_t repeat) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Cannot open input file.\n";
+        exit(EXIT_FAILURE);
+    }
+    std::string prelude, body, line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t");
+        bool isDirective = first != std::string::npos && line[first] == '#';
+        (isDirective ? prelude : body) += line + '\n';
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "pluma_bench_program.c";
+    std::ofstream out(path, std::ios::binary);
+    out << prelude;
+    for (size_t i = 0; i < repeat; ++i) {
+        out << body;
+    }
+    return path.string();
+}
+
+bool sameStream(const TokenStream &expected, const TokenStream &actual) {
+    if (expected.size() != actual.size()) {
+        std::cerr << "token count differs: " << expected.size() << " vs " << actual.size()
+                  << '\n';
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected.type(i) != actual.type(i) || expected.offset(i) != actual.offset(i) ||
+            expected.length(i) != actual.length(i)) {
+            std::cerr << "token " << i << " differs: " << expected.text(i) << " vs "
+                      << actual.text(i) << '\n';
+            return false;
+        }
+    }
+    auto expectedComments = expected.allComments(), actualComments = actual.allComments();
+    if (expectedComments.size() != actualComments.size()) {
+        std::cerr << "comment count differs: " << expectedComments.size() << " vs "
+                  << actualComments.size() << '\n';
+        return false;
+    }
+    for (size_t i = 0; i < expectedComments.size(); ++i) {
+        auto &lhs = expectedComments[i], &rhs = actualComments[i];
+        if (lhs.tokenIndex != rhs.tokenIndex || lhs.offset != rhs.offset ||
+            lhs.length != rhs.length) {
+            std::cerr << "comment " << i << " differs\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// The "<field>: <n> kB" line of /proc/self/status.
+static size_t statusKiB(const std::string &field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0 && line[field.size()] == ':') {
+            return std::strtoul(line.c_str() + field.size() + 1, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+size_t residentKiB() { return statusKiB("VmRSS"); }
+
+size_t peakResidentKiB() { return statusKiB("VmHWM"); }
+
+void resetPeakResident() {
+#ifdef __GLIBC__
+    // Return what earlier frees left in the arenas first, so that it is not
+    // counted against whatever runs next.
+    malloc_trim(0);
+#endif
+    // Writing 5 to clear_refs resets VmHWM to the current VmRSS.
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+void report(const std::string &suite, const std::string &name, double value,
+            const std::string &unit) {
+    std::cout << std::left << std::setw(40) << (suite + "/" + name) << std::right
+              << std::setw(14) << std::fixed << std::setprecision(2) << value << ' ' << unit
+              << std::endl;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <suite> <input_file> [repeat]\n", argv[0]);
+        fprintf(stderr, "Suites: lexer keyword dfa parallel incremental utf8 parse construct\n");
+        exit(EXIT_FAILURE);
+    }
+    std::string suite = argv[1];
+    std::string inputFilename = argv[2];
+    size_t repeat = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1;
+
+    bool ok = false;
+    if (suite == "lexer") {
+        ok = pluma::bench::lexerBench(inputFilename, repeat);
+    } else if (suite == "keyword") {
+        ok = pluma::bench::keywordBench(inputFilename, repeat);
+    } else if (suite == "dfa") {
+        ok = pluma::bench::dfaBench(inputFilename, repeat);
+    } else if (suite == "parallel") {
+        ok = pluma::bench::parallelBench(inputFilename, repeat);
+    } else if (suite == "incremental") {
+        ok = pluma::bench::incrementalBench(inputFilename, repeat);
+    } else if (suite == "utf8") {
+        ok = pluma::bench::utf8Bench(inputFilename, repeat);
+    } else if (suite == "parse") {
+        ok = pluma::bench::parseBench(inputFilename, repeat);
+    } else if (suite == "construct") {
+        ok = pluma::bench::constructBench(inputFilename, repeat);
+    } else {
+        fprintf(stderr, "Unknown suite: %s\n", suite.c_str());
+        exit(EXIT_FAILURE);
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
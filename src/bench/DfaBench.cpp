@@ -0,0 +1,184 @@
+#include <vector>
+
+#include "Lexer.h"
+#include "LexerDfa.hpp"
+#include "bench/Bench.h"
+
+namespace pluma {
+
+namespace bench {
+
+// The hand-written operator switch the lexer used before the DFA, reduced to
+// the match itself: returns the end of the lexeme, or `p` if nothing matches.
+static const char *switchMatch(const char *p, const char *end, TokenType &type) {
+    const char *cursor = p;
+    auto expect = [&](char expectedChar) {
+        if (cursor < end && *cursor == expectedChar) {
+            ++cursor;
+            return true;
+        }
+        return false;
+    };
+    auto make = [&](TokenType matched) {
+        type = matched;
+        return cursor;
+    };
+
+    switch (*cursor++) {
+        case '+': {
+            if (expect('+')) return make(TokenType::INCR);
+            if (expect('=')) return make(TokenType::ADD_ASSIGN);
+            return make(TokenType::ADD);
+        }
+        case '-': {
+            if (expect('-')) return make(TokenType::DECR);
+            if (expect('>')) return make(TokenType::ARROW);
+            if (expect('=')) return make(TokenType::SUB_ASSIGN);
+            return make(TokenType::SUB);
+        }
+        case '*': {
+            if (expect('=')) return make(TokenType::MUL_ASSIGN);
+            return make(TokenType::MUL);
+        }
+        case '/': {
+            if (expect('=')) return make(TokenType::DIV_ASSIGN);
+            if (expect('/')) return make(TokenType::LINE_COMMENT);
+            if (expect('*')) return make(TokenType::BLOCK_COMMENT);
+            return make(TokenType::DIV);
+        }
+        case '%': {
+            if (expect('=')) return make(TokenType::MOD_ASSIGN);
+            return make(TokenType::MOD);
+        }
+        case '&': {
+            if (expect('&')) return make(TokenType::AND);
+            if (expect('=')) return make(TokenType::BITAND_ASSIGN);
+            return make(TokenType::BITAND);
+        }
+        case '|': {
+            if (expect('|')) return make(TokenType::OR);
+            if (expect('=')) return make(TokenType::BITOR_ASSIGN);
+            return make(TokenType::BITOR);
+        }
+        case '^': {
+            if (expect('=')) return make(TokenType::BITXOR_ASSIGN);
+            return make(TokenType::BITXOR);
+        }
+        case '<': {
+            if (expect('<')) {
+                if (expect('=')) return make(TokenType::LSHIFT_ASSIGN);
+                return make(TokenType::LSHIFT);
+            }
+            if (expect('=')) return make(TokenType::LE);
+            return make(TokenType::LT);
+        }
+        case '>': {
+            if (expect('>')) {
+                if (expect('=')) return make(TokenType::RSHIFT_ASSIGN);
+                return make(TokenType::RSHIFT);
+            }
+            if (expect('=')) return make(TokenType::GE);
+            return make(TokenType::GT);
+        }
+        case '=': {
+            if (expect('=')) return make(TokenType::EQ);
+            return make(TokenType::ASSIGN);
+        }
+        case '~':
+            return make(TokenType::BITNOT);
+        case '!': {
+            if (expect('=')) return make(TokenType::NEQ);
+            return make(TokenType::NOT);
+        }
+        case '(':
+            return make(TokenType::LPAREN);
+        case ')':
+            return make(TokenType::RPAREN);
+        case '[':
+            return make(TokenType::LSBRACKET);
+        case ']':
+            return make(TokenType::RSBRACKET);
+        case '{':
+            return make(TokenType::LBRACE);
+        case '}':
+            return make(TokenType::RBRACE);
+        case ',':
+            return make(TokenType::COMMA);
+        case '.':
+            return make(TokenType::PERIOD);
+        case ':': {
+            if (expect(':')) return make(TokenType::DBL_COLON);
+            return make(TokenType::COLON);
+        }
+        case ';':
+            return make(TokenType::SEMICOLON);
+        case '?':
+            return make(TokenType::QUESTION_MARK);
+        case '#':
+            return make(TokenType::SHARP);
+        default:
+            type = TokenType::UNKNOWN;
+            return p;
+    }
+}
+
+// Matches at every token and comment start of the input, once with the old
+// switch and once with the table DFA, and checks they agree.
+bool dfaBench(const std::string &filename, size_t repeat) {
+    Lexer lexer(filename);
+    TokenStream tokens = lexer.tokenize();
+    const char *base = tokens.buffer().data();
+    const char *end = tokens.buffer().end();
+
+    std::vector<const char *> starts;
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+        starts.push_back(base + tokens.offset(i));
+    }
+    for (auto &comment : tokens.allComments()) {
+        starts.push_back(base + comment.offset);
+    }
+    if (starts.empty()) {
+        std::cerr << "dfa: no tokens in the input\n";
+        return false;
+    }
+
+    size_t rounds = repeat * ((10000000 + starts.size() - 1) / starts.size());
+    size_t matches = rounds * starts.size();
+    std::vector<TokenType> switchTypes(starts.size()), dfaTypes(starts.size());
+    std::vector<const char *> switchEnds(starts.size()), dfaEnds(starts.size());
+
+    Stopwatch watch;
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < starts.size(); ++i) {
+            switchEnds[i] = switchMatch(starts[i], end, switchTypes[i]);
+        }
+        asm volatile("" : : "r"(switchEnds.data()) : "memory");
+    }
+    double switchSeconds = watch.seconds();
+
+    watch.restart();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < starts.size(); ++i) {
+            dfaEnds[i] = lexer_dfa::match(starts[i], end, dfaTypes[i]);
+        }
+        asm volatile("" : : "r"(dfaEnds.data()) : "memory");
+    }
+    double dfaSeconds = watch.seconds();
+
+    report("dfa", "lexemes", (double)starts.size(), "lexemes");
+    report("dfa", "states", (double)lexer_dfa::dfa.stateCount, "states");
+    report("dfa", "classes", (double)lexer_dfa::classCount, "classes");
+    report("dfa", "switch", switchSeconds * 1e9 / matches, "ns/match");
+    report("dfa", "table", dfaSeconds * 1e9 / matches, "ns/match");
+    report("dfa", "speedup", switchSeconds / dfaSeconds, "x");
+
+    bool same = switchTypes == dfaTypes && switchEnds == dfaEnds;
+    if (!same) {
+        std::cerr << "dfa: table DFA and switch disagree\n";
+    }
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
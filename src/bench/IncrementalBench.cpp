@@ -0,0 +1,81 @@
+#include <filesystem>
+#include <random>
+
+#include "Lexer.h"
+#include "bench/Bench.h"
+
+namespace pluma {
+
+namespace bench {
+
+// Types a line character by character at random line starts of the input,
+// then deletes it again, and also cuts and restores whole lines. Every edit is
+// re-lexed incrementally and checked against a full tokenize() of the result.
+bool incrementalBench(const std::string &filename, size_t repeat) {
+    std::string path = scaleInput(filename, repeat);
+    Lexer lexer(path);
+    TokenStream tokens = lexer.tokenize();
+
+    const std::string typed = "int zz = a + b; // note\n";
+    std::mt19937 random(42);
+    double relexSeconds = 0, fullSeconds = 0;
+    size_t edits = 0;
+    bool same = true;
+
+    auto apply = [&](const TextEdit &edit) {
+        Stopwatch watch;
+        Lexer::relex(tokens, edit);
+        relexSeconds += watch.seconds();
+
+        watch.restart();
+        Lexer fullLexer(tokens.sharedBuffer());
+        TokenStream expected = fullLexer.tokenize();
+        fullSeconds += watch.seconds();
+
+        if (same && !sameStream(expected, tokens)) {
+            std::cerr << "incremental: edit at " << edit.offset << " differs\n";
+            same = false;
+        }
+        ++edits;
+    };
+
+    auto lineStart = [&]() {
+        const utils::SourceBuffer &buffer = tokens.buffer();
+        size_t offset = std::uniform_int_distribution<size_t>(0, buffer.size() - 1)(random);
+        while (offset > 0 && buffer.data()[offset - 1] != '\n') {
+            --offset;
+        }
+        return offset;
+    };
+
+    for (size_t round = 0; round < 20; ++round) {
+        size_t offset = lineStart();
+        for (size_t i = 0; i < typed.size(); ++i) {
+            apply(TextEdit{offset + i, 0, typed.substr(i, 1)});
+        }
+        for (size_t i = typed.size(); i > 0; --i) {
+            apply(TextEdit{offset + i - 1, 1, ""});
+        }
+
+        offset = lineStart();
+        const utils::SourceBuffer &buffer = tokens.buffer();
+        size_t length = 0;
+        while (offset + length < buffer.size() && buffer.data()[offset + length] != '\n') {
+            ++length;
+        }
+        std::string line(buffer.data() + offset, length);
+        apply(TextEdit{offset, length, ""});
+        apply(TextEdit{offset, 0, line});
+    }
+
+    report("incremental", "lines", (double)tokens.line(tokens.size() - 1), "lines");
+    report("incremental", "edits", (double)edits, "edits");
+    report("incremental", "full", fullSeconds * 1e6 / edits, "us/edit");
+    report("incremental", "relex", relexSeconds * 1e6 / edits, "us/edit");
+    report("incremental", "speedup", fullSeconds / relexSeconds, "x");
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
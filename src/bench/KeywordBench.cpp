@@ -0,0 +1,81 @@
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "Keyword.hpp"
+#include "Lexer.h"
+#include "bench/Bench.h"
+
+namespace pluma {
+
+namespace bench {
+
+// Identifier-shaped lexemes of the input, looked up with the std::map pair the
+// lexer used to consult and with the perfect hash it uses now.
+bool keywordBench(const std::string &filename, size_t repeat) {
+    Lexer lexer(filename);
+    TokenStream tokens = lexer.tokenize();
+
+    std::vector<std::string_view> words;
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+        std::string_view value = tokens.text(i);
+        if (!value.empty() && (isalpha(value[0]) || value[0] == '_')) {
+            words.push_back(value);
+        }
+    }
+    if (words.empty()) {
+        std::cerr << "keyword: no identifiers in the input\n";
+        return false;
+    }
+
+    std::map<std::string, TokenType> keywordMap, preprocessorMap;
+    for (auto &entry : keywordList) {
+        bool isDirective =
+            entry.tokenType == TokenType::INCLUDE || entry.tokenType == TokenType::DEFINE;
+        (isDirective ? preprocessorMap : keywordMap).emplace(entry.text, entry.tokenType);
+    }
+
+    size_t rounds = repeat * ((10000000 + words.size() - 1) / words.size());
+    size_t lookups = rounds * words.size();
+    std::vector<TokenType> mapTypes(words.size()), hashTypes(words.size());
+
+    Stopwatch watch;
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < words.size(); ++i) {
+            std::string value(words[i]);
+            TokenType type = TokenType::IDENTIFIER;
+            if (auto token_pair = keywordMap.find(value); token_pair != keywordMap.end()) {
+                type = token_pair->second;
+            } else if (auto token_pair = preprocessorMap.find(value);
+                       token_pair != preprocessorMap.end()) {
+                type = token_pair->second;
+            }
+            mapTypes[i] = type;
+        }
+    }
+    double mapSeconds = watch.seconds();
+
+    watch.restart();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < words.size(); ++i) {
+            hashTypes[i] = lookupKeyword(words[i]);
+        }
+        asm volatile("" : : "r"(hashTypes.data()) : "memory");
+    }
+    double hashSeconds = watch.seconds();
+
+    report("keyword", "words", (double)words.size(), "words");
+    report("keyword", "std::map", mapSeconds * 1e9 / lookups, "ns/lookup");
+    report("keyword", "perfect-hash", hashSeconds * 1e9 / lookups, "ns/lookup");
+    report("keyword", "speedup", mapSeconds / hashSeconds, "x");
+
+    bool same = mapTypes == hashTypes;
+    if (!same) {
+        std::cerr << "keyword: perfect hash and std::map disagree\n";
+    }
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
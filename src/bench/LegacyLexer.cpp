@@ -0,0 +1,555 @@
+#include "bench/LegacyLexer.h"
+
+#include "Keyword.hpp"
+#include "main.h"
+
+namespace pluma {
+
+namespace bench {
+
+LegacyToken::LegacyToken() : value(""), tokenType(TokenType::UNKNOWN), line(0) {}
+
+LegacyToken::LegacyToken(std::string _value, TokenType _type, size_t _line)
+    : value(std::move(_value)), tokenType(_type), line(_line) {}
+
+LegacyLexer::LegacyLexer(const std::string &inputFilename) {
+    this->inputFile.open(inputFilename);
+
+    if (!this->inputFile.is_open()) {
+        std::cerr << "Cannot open input file.\n";
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Get a char; if the next character is the expected one, return it;
+// else unget and return 0.
+static char expectChar(std::fstream &file, char expectedChar) {
+    char actualChar = file.get();
+    if (actualChar == expectedChar) {
+        return actualChar;
+    } else if (actualChar == -1) {
+        return -1;
+    } else {
+        file.unget();
+        return 0;
+    }
+}
+LegacyToken LegacyLexer::scan(std::fstream &file) {
+    if (file.eof()) {
+        return LegacyToken();
+    }
+
+    while (!file.eof()) {
+        // Skip blank character.
+        for (; isblank(peek) || peek == '\n'; peek = file.get()) {
+            if (peek == '\n') {
+                ++line;
+            }
+        }
+        if (file.eof()) {
+            return LegacyToken();
+        }
+
+        {
+            std::string value = "";
+            switch (peek) {
+                case '+': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '+');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::INCR, line);
+                    }
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::ADD_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::ADD, line);
+                    break;
+                }
+                case '-': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '-');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::DECR, line);
+                    }
+                    peek = expectChar(file, '>');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::ARROW, line);
+                    }
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::SUB_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::SUB, line);
+                    break;
+                }
+                case '*': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::MUL_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::MUL, line);
+                    break;
+                }
+                case '/': {
+                    value.push_back(peek);
+
+                    // "/="
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::DIV_ASSIGN, line);
+                    }
+
+                    // "//"
+                    peek = expectChar(file, '/');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        while ((peek = file.get()) != '\n') {
+                            value.push_back(peek);
+                        }
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::LINE_COMMENT, line++);
+                    }
+
+                    // "/* */"
+                    peek = expectChar(file, '*');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        for (peek = file.get(); peek != -1 && peek != '*'; peek = file.get()) {
+                            value.push_back(peek);
+                            if (peek == '\n') {
+                                ++line;
+                            }
+                        }
+                        switch (peek) {
+                            case -1: {
+                                char errmsg[63];
+                                sprintf(errmsg,
+                                        "At line %d:\n"
+                                        "Block comment doesn't close.\n",
+                                        line);
+                                panic(errmsg);
+                                return LegacyToken();
+                                break;
+                            }
+                            case '*': {
+                                value.push_back(peek);
+                                peek = expectChar(file, '/');
+                                if (peek && peek != -1) {
+                                    value.push_back(peek);
+                                    peek = file.get();
+                                    return LegacyToken(value, TokenType::BLOCK_COMMENT, line);
+                                } else {
+                                    char errmsg[63];
+                                    sprintf(errmsg,
+                                            "At line %d:\n"
+                                            "Block comment doesn't close.\n",
+                                            line);
+                                    panic(errmsg);
+                                    return LegacyToken();
+                                    break;
+                                }
+                            }
+                        }
+                    }
+
+                    // "/"
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::DIV, line);
+                    break;
+                }
+                case '%': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::MOD_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::MOD, line);
+                    break;
+                }
+                case '&': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '&');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::AND, line);
+                    }
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::BITAND_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::BITAND, line);
+                    break;
+                }
+                case '|': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '|');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::OR, line);
+                    }
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::BITOR_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::BITOR, line);
+                    break;
+                }
+                case '^': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::BITXOR_ASSIGN, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::BITXOR, line);
+                    break;
+                }
+                case '<': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '<');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = expectChar(file, '=');
+                        if (peek && peek != -1) {
+                            value.push_back(peek);
+                            peek = file.get();
+                            return LegacyToken(value, TokenType::LSHIFT_ASSIGN, line);
+                        }
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::LSHIFT, line);
+                    }
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::LE, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::LT, line);
+                }
+                case '>': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '>');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = expectChar(file, '=');
+                        if (peek && peek != -1) {
+                            value.push_back(peek);
+                            peek = file.get();
+                            return LegacyToken(value, TokenType::RSHIFT_ASSIGN, line);
+                        }
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::RSHIFT, line);
+                    }
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::GE, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::GT, line);
+                }
+                case '=': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::EQ, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::ASSIGN, line);
+                    break;
+                }
+                case '~': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::BITNOT, line);
+                }
+                case '!': {
+                    value.push_back(peek);
+                    peek = expectChar(file, '=');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::NEQ, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::NOT, line);
+                }
+
+                // Brackets.
+                case '(': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::LPAREN, line);
+                }
+                case ')': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::RPAREN, line);
+                }
+                case '[': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::LSBRACKET, line);
+                }
+                case ']': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::RSBRACKET, line);
+                }
+                case '{': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::LBRACE, line);
+                }
+                case '}': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::RBRACE, line);
+                }
+
+                case ',': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::COMMA, line);
+                }
+                case '.': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    // Check if the successor is a digit.
+                    if (!isdigit(peek)) {
+                        return LegacyToken(value, TokenType::PERIOD, line);
+                    } else {
+                        // If the successor is a digit, recover from the status
+                        // before and break.
+                        value.pop_back();
+                        file.unget();
+                        peek = '.';
+                        break;
+                    }
+                }
+                case ':': {
+                    value.push_back(peek);
+                    peek = expectChar(file, ':');
+                    if (peek && peek != -1) {
+                        value.push_back(peek);
+                        peek = file.get();
+                        return LegacyToken(value, TokenType::DBL_COLON, line);
+                    }
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::COLON, line);
+                }
+                case ';': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::SEMICOLON, line);
+                }
+                case '?': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::QUESTION_MARK, line);
+                }
+
+                case '#': {
+                    value.push_back(peek);
+                    peek = file.get();
+                    return LegacyToken(value, TokenType::SHARP, line);
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        // Handle keywords and identifiers.
+        if (isalpha(peek) || peek == '_') {
+            std::string value = "";
+
+            do {
+                value.push_back(peek);
+                peek = file.get();
+            } while (isalpha(peek) || isdigit(peek) || peek == '_');
+
+            return LegacyToken(value, lookupKeyword(value), line);
+        }
+
+        // Handle C-style string constant.
+        if (peek == '\"') {
+            std::string value = "";
+            value.push_back(peek);
+            while ((peek = file.get()) != '\"') {
+                if (file.eof() || peek == '\n') {
+                    char errmsg[63];
+                    sprintf(errmsg,
+                            "At line %d:\n"
+                            "String constant doesn't close.\n",
+                            line);
+                    panic(errmsg);
+                    return LegacyToken();
+                }
+                value.push_back(peek);
+            }
+            value.push_back(peek);
+            peek = file.get();
+            return LegacyToken(value, TokenType::STRING_CONST, line);
+        }
+
+        // Handle character constant.
+        if (peek == '\'') {
+            std::string value = "";
+
+            value.push_back(peek);
+
+            peek = expectChar(file, '\\');
+            if (peek && peek != -1) {
+                value.push_back(peek);
+            }
+            peek = file.get();
+            if (!isascii(peek)) {
+                char errmsg[63];
+                sprintf(errmsg,
+                        "At line %d:\n"
+                        "Character constant includes non-ascii character!\n",
+                        line);
+                panic(errmsg);
+                return LegacyToken();
+            }
+            value.push_back(peek);
+            peek = expectChar(file, '\'');
+            if (!peek) {
+                char errmsg[127];
+                sprintf(errmsg,
+                        "At line %d:\n"
+                        "Quotation mark doesn't close, or there are more than "
+                        "1 character in the char constant.\n",
+                        line);
+                panic(errmsg);
+                return LegacyToken();
+            }
+            value.push_back(peek);
+            peek = file.get();
+            return LegacyToken(value, TokenType::CHAR_CONST, line);
+        }
+
+        // Handle numbers.
+        if (isdigit(peek) || peek == '.') {
+            std::string value = "";
+            bool isFloat = (peek == '.') ? true : false;
+            bool isHex = false;
+
+            value.push_back(peek);
+
+            while ((peek = file.get())) {
+                if (isdigit(peek)) {
+                } else if (peek == '.') {
+                    if (isFloat) {
+                        char errmsg[63];
+                        sprintf(errmsg,
+                                "At line %d:\n"
+                                "Character \'.\' appears twice in a float.\n",
+                                line);
+                        panic(errmsg);
+                    }
+                    isFloat = true;
+                } else if (peek == 'x' || peek == 'X') {
+                    if (value.length() != 1 || value[0] != '0') {
+                        char errmsg[63];
+                        sprintf(errmsg,
+                                "At line %d:\n"
+                                "Wrong character appeared in a number\n",
+                                line);
+                        panic(errmsg);
+                    }
+                    isHex = true;
+                } else if (isalpha(peek)) {
+                    if (!(isHex &&
+                          ((peek >= 'a' && peek <= 'f') || (peek >= 'A' && peek <= 'F')))) {
+                        char errmsg[63];
+                        sprintf(errmsg,
+                                "At line %d:\n"
+                                "Wrong character appeared in a number\n",
+                                line);
+                        panic(errmsg);
+                    }
+                } else {
+                    break;
+                }
+                value.push_back(peek);
+            }
+            if (isFloat) {
+                if (isHex) {
+                    char errmsg[63];
+                    sprintf(errmsg,
+                            "At line %d:\n"
+                            "Wrong character appeared in a number\n",
+                            line);
+                    panic(errmsg);
+                    return LegacyToken();
+                }
+                return LegacyToken(value, TokenType::FLOAT_CONST, line);
+            } else {
+                return LegacyToken(value, TokenType::INT_CONST, line);
+            }
+        }
+    }
+    return LegacyToken();
+}
+std::vector<LegacySym> LegacyLexer::tokenize() {
+    std::vector<LegacySym> symVec;
+    while (!this->inputFile.eof()) {
+        LegacyToken token = this->scan(this->inputFile);
+        if (token.tokenType != pluma::TokenType::UNKNOWN) {
+            if (token.tokenType != TokenType::BLOCK_COMMENT &&
+                token.tokenType != TokenType::LINE_COMMENT) {
+                symVec.push_back(LegacyTerminal{token});
+            } else {
+                auto prevNoncommentSymIter = symVec.rbegin();
+                if (prevNoncommentSymIter != symVec.rend()) {
+                    // A comment belongs to its previous token.
+                    std::get<LegacyTerminal>(*prevNoncommentSymIter).token.comments.push_back(token);
+                }
+            }
+        }
+    }
+    symVec.push_back(LegacyTerminal{LegacyToken{"EOF", pluma::TokenType::TK_EOF}});
+    return symVec;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
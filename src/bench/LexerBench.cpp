@@ -0,0 +1,118 @@
+#include <filesystem>
+#include <vector>
+
+#include "Lexer.h"
+#include "bench/Bench.h"
+#include "bench/LegacyLexer.h"
+#include "utils/Simd.h"
+
+namespace pluma {
+
+namespace bench {
+
+static bool sameToken(const LegacyToken &legacy, TokenType type, std::string_view value,
+                      size_t line) {
+    return legacy.tokenType == type && legacy.value == value && legacy.line == line;
+}
+
+static bool sameTokens(const std::vector<LegacySym> &legacySyms, const TokenStream &tokens) {
+    if (legacySyms.size() != tokens.size()) {
+        std::cerr << "token count differs: " << legacySyms.size() << " vs " << tokens.size()
+                  << '\n';
+        return false;
+    }
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+        auto &legacy = std::get<LegacyTerminal>(legacySyms[i]).token;
+        auto comments = tokens.commentsOf(i);
+        bool same = sameToken(legacy, tokens.type(i), tokens.text(i), tokens.line(i)) &&
+                    legacy.comments.size() == comments.size();
+        for (size_t j = 0; same && j < comments.size(); ++j) {
+            // The legacy lexer gives a block comment the line it ends on.
+            size_t commentEnd = comments[j].offset + comments[j].length - 1;
+            same = legacy.comments[j].value == tokens.text(comments[j]) &&
+                   legacy.comments[j].line == tokens.lines().line(commentEnd);
+        }
+        if (!same) {
+            std::cerr << "token " << i << " differs: " << legacy.value << " vs "
+                      << tokens.text(i) << '\n';
+            return false;
+        }
+    }
+    return tokens.type(tokens.size() - 1) == TokenType::TK_EOF;
+}
+
+static size_t heapBytes(const LegacyToken &token) {
+    // Strings longer than the small-string buffer allocate.
+    size_t bytes = token.value.capacity() > 15 ? token.value.capacity() + 1 : 0;
+    bytes += token.comments.capacity() * sizeof(LegacyToken);
+    for (auto &comment : token.comments) {
+        bytes += heapBytes(comment);
+    }
+    return bytes;
+}
+
+static size_t memoryUsage(const std::vector<LegacySym> &legacySyms) {
+    size_t bytes = legacySyms.capacity() * sizeof(LegacySym);
+    for (auto &sym : legacySyms) {
+        bytes += heapBytes(std::get<LegacyTerminal>(sym).token);
+    }
+    return bytes;
+}
+
+bool lexerBench(const std::string &filename, size_t repeat) {
+    std::string path = scaleInput(filename, repeat);
+    double megabytes = (double)std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+    Stopwatch watch;
+    LegacyLexer legacyLexer(path);
+    std::vector<LegacySym> legacySyms = legacyLexer.tokenize();
+    double legacySeconds = watch.seconds();
+
+    watch.restart();
+    Lexer lexer(path);
+    TokenStream tokens = lexer.tokenize();
+    double bufferSeconds = watch.seconds();
+
+    report("lexer", "input", megabytes, "MB");
+    report("lexer", "tokens", (double)tokens.size(), "tokens");
+    report("lexer", "stream", megabytes / legacySeconds, "MB/s");
+    report("lexer", "buffer", megabytes / bufferSeconds, "MB/s");
+    report("lexer", "speedup", legacySeconds / bufferSeconds, "x");
+    report("lexer", "memory-sym-vector", (double)memoryUsage(legacySyms) / legacySyms.size(),
+           "bytes/token");
+    report("lexer", "memory-token-stream", (double)tokens.memoryUsage() / tokens.size(),
+           "bytes/token");
+
+    watch.restart();
+    utils::LineIndex lineIndex(tokens.buffer().begin(), tokens.buffer().end());
+    report("lexer", "line-index", megabytes / watch.seconds(), "MB/s");
+
+    bool same = sameTokens(legacySyms, tokens);
+    if (!same) {
+        std::cerr << "lexer: stream and buffer token streams differ\n";
+    }
+
+    // The buffer lexer once per scanning-kernel level.
+    utils::SimdLevel defaultLevel = utils::simdLevel();
+    for (int level = (int)utils::SimdLevel::SCALAR; level <= (int)utils::maxSimdLevel(); ++level) {
+        utils::setSimdLevel((utils::SimdLevel)level);
+        watch.restart();
+        Lexer levelLexer(path);
+        TokenStream levelTokens = levelLexer.tokenize();
+        double levelSeconds = watch.seconds();
+        report("lexer", std::string("buffer-") + utils::simdLevelName((utils::SimdLevel)level),
+               megabytes / levelSeconds, "MB/s");
+        if (!sameTokens(legacySyms, levelTokens)) {
+            std::cerr << "lexer: " << utils::simdLevelName((utils::SimdLevel)level)
+                      << " kernels changed the token stream\n";
+            same = false;
+        }
+    }
+    utils::setSimdLevel(defaultLevel);
+
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
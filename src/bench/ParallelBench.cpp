@@ -0,0 +1,42 @@
+#include <filesystem>
+#include <thread>
+
+#include "Lexer.h"
+#include "bench/Bench.h"
+
+namespace pluma {
+
+namespace bench {
+
+// Sequential tokenize() against tokenizeParallel() at several thread counts.
+bool parallelBench(const std::string &filename, size_t repeat) {
+    std::string path = scaleInput(filename, repeat);
+    double megabytes = (double)std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+    Stopwatch watch;
+    Lexer lexer(path);
+    TokenStream expected = lexer.tokenize();
+    double sequentialSeconds = watch.seconds();
+
+    report("parallel", "input", megabytes, "MB");
+    report("parallel", "cores", (double)std::thread::hardware_concurrency(), "cores");
+    report("parallel", "sequential", megabytes / sequentialSeconds, "MB/s");
+
+    bool same = true;
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        watch.restart();
+        Lexer parallelLexer(path);
+        TokenStream actual = parallelLexer.tokenizeParallel(threads);
+        double seconds = watch.seconds();
+        report("parallel", "threads-" + std::to_string(threads), megabytes / seconds, "MB/s");
+        if (!sameStream(expected, actual)) {
+            std::cerr << "parallel: " << threads << " threads changed the token stream\n";
+            same = false;
+        }
+    }
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
@@ -0,0 +1,439 @@
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Lexer.h"
+#include "bench/Bench.h"
+#include "c/CParser.h"
+#ifdef PLUMA_DIRECT_PARSER
+#include "c/CDirectParser.h"
+#endif
+
+namespace pluma {
+
+namespace bench {
+
+using LR1_TableType = Grammar::LR1_TableType;
+
+// The lookup the parser made before the dense table: two tree walks, and an
+// ERROR action inserted on every miss.
+static Action mapTableRead(LR1_TableType &table, const size_t &state, const Sym &sym) {
+    auto &actionSet = table[state][sym];
+    if (actionSet.size() == 0) {
+        actionSet.insert(Action{Action::ActionType::ERROR, (size_t)(-1), Terminal{Token{}}});
+    } else if (actionSet.size() == 2) {
+        for (auto &action : actionSet) {
+            if (action.actionType == Action::ActionType::PUSH_STACK) {
+                return action;
+            }
+        }
+    }
+    return *(actionSet.begin());
+}
+
+// The nested std::map layout the parser ran on before the dense table, one
+// action per cell, rebuilt from the dense table.
+static LR1_TableType mapTableOf(const ParseTable &table, const std::vector<Rule> &rules) {
+    std::vector<Nonterminal> nonterminals(table.nonterminals());
+    for (size_t i = 0; i < rules.size(); ++i) {
+        nonterminals[table.ruleLhs(i)] = rules[i].first;
+    }
+
+    LR1_TableType mapTable;
+    const Terminal nil{Token{"nil", TokenType::NIL}};
+    for (size_t state = 0; state < table.states(); ++state) {
+        for (int type = TokenType::TK_EOF; type + 1 < (int)tokenTypeCount; ++type) {
+            ParseTable::Word action = table.action(state, (TokenType)type);
+            size_t target = ParseTable::targetOf(action);
+            Sym sym = Terminal{Token{"", (TokenType)type}};
+            switch (ParseTable::kindOf(action)) {
+                case ParseTable::Kind::PUSH_STACK: {
+                    mapTable[state][sym].insert(
+                        Action{Action::ActionType::PUSH_STACK, target, nil});
+                    break;
+                }
+                case ParseTable::Kind::REDUCE: {
+                    mapTable[state][sym].insert(Action{Action::ActionType::REDUCE, target, nil});
+                    break;
+                }
+                case ParseTable::Kind::ACCEPT: {
+                    mapTable[state][sym].insert(
+                        Action{Action::ActionType::ACCEPT, (size_t)10000, nil});
+                    break;
+                }
+                case ParseTable::Kind::ERROR: {
+                    break;
+                }
+            }
+        }
+        for (size_t nonterminal = 0; nonterminal < table.nonterminals(); ++nonterminal) {
+            ParseTable::Word target = table.gotoState(state, nonterminal);
+            if (target != ParseTable::noState) {
+                mapTable[state][nonterminals[nonterminal]].insert(
+                    Action{Action::ActionType::GOTO, target, nil});
+            }
+        }
+    }
+    return mapTable;
+}
+
+// Rough heap size of the nested maps: every red-black tree node carries three
+// pointers and a colour ahead of its value.
+static size_t mapTableMemory(const LR1_TableType &table) {
+    constexpr size_t nodeOverhead = 32;
+    size_t bytes = sizeof(table);
+    for (auto &[state, row] : table) {
+        bytes += nodeOverhead + sizeof(*table.begin());
+        for (auto &[sym, actionSet] : row) {
+            bytes += nodeOverhead + sizeof(*row.begin());
+            bytes += actionSet.size() * (nodeOverhead + sizeof(Action));
+            if (auto nonterminal = std::get_if<Nonterminal>(&sym);
+                nonterminal && nonterminal->token.capacity() > 15) {
+                bytes += nonterminal->token.capacity() + 1;
+            }
+        }
+    }
+    return bytes;
+}
+
+// Runs the automaton of Grammar::gen() without building the tree, and records
+// the rules it reduces. Returns true if the input was accepted.
+static bool recognizeWithMap(LR1_TableType &table, size_t beginState,
+                             const std::vector<Rule> &rules, const TokenStream &tokens,
+                             std::vector<uint32_t> &reduced) {
+    std::vector<size_t> stateStack{beginState};
+    size_t strPos = 0;
+    while (1) {
+        const Sym currSym = Terminal{tokens.token(strPos)};
+        size_t state = stateStack.back();
+        Action action = mapTableRead(table, state, currSym);
+        Action epsilonAction = mapTableRead(table, state, Terminal{Token{"nil", TokenType::NIL}});
+        bool isRuleEpsilon = action.actionType == Action::ActionType::ERROR;
+        if (isRuleEpsilon) {
+            action = epsilonAction;
+        }
+        switch (action.actionType) {
+            case Action::ActionType::REDUCE: {
+                auto &rule = rules[action.state];
+                stateStack.resize(stateStack.size() - rule.second.size());
+                Action gotoAction = mapTableRead(table, stateStack.back(), rule.first);
+                if (gotoAction.actionType != Action::ActionType::GOTO) {
+                    return false;
+                }
+                stateStack.push_back(gotoAction.state);
+                reduced.push_back(action.state);
+                break;
+            }
+            case Action::ActionType::PUSH_STACK: {
+                stateStack.push_back(action.state);
+                strPos += !isRuleEpsilon;
+                break;
+            }
+            case Action::ActionType::ACCEPT: {
+                return true;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+}
+
+// Same for ParseTable and CompressedParseTable.
+template <typename Table>
+static bool recognizeWithTable(const Table &table, const TokenStream &tokens,
+                               std::vector<uint32_t> &reduced) {
+    std::vector<size_t> stateStack{table.startState()};
+    size_t strPos = 0;
+    while (1) {
+        size_t state = stateStack.back();
+        ParseTable::Word action = table.action(state, tokens.type(strPos));
+        bool isRuleEpsilon = false;
+        if (ParseTable::kindOf(action) == ParseTable::Kind::ERROR) {
+            action = table.epsilonAction(state);
+            isRuleEpsilon = true;
+        }
+        size_t target = ParseTable::targetOf(action);
+        switch (ParseTable::kindOf(action)) {
+            case ParseTable::Kind::REDUCE: {
+                stateStack.resize(stateStack.size() - table.ruleLength(target));
+                ParseTable::Word gotoState =
+                    table.gotoState(stateStack.back(), table.ruleLhs(target));
+                if (gotoState == ParseTable::noState) {
+                    return false;
+                }
+                stateStack.push_back(gotoState);
+                reduced.push_back(target);
+                break;
+            }
+            case ParseTable::Kind::PUSH_STACK: {
+                stateStack.push_back(target);
+                strPos += !isRuleEpsilon;
+                break;
+            }
+            case ParseTable::Kind::ACCEPT: {
+                return true;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+}
+
+// Hash of the symbols and shape of a tree, so trees too big to hold two of
+// can be compared one at a time, and its node count. Does not recurse:
+// sibling lists run as long as the program.
+static uint64_t treeHash(const AstNode *root, size_t &nodes) {
+    nodes = 0;
+    uint64_t hash = 0xcbf29ce484222325;
+    auto mix = [&hash](std::string_view bytes) {
+        for (char byte : bytes) {
+            hash = (hash ^ (uint8_t)byte) * 0x100000001b3;
+        }
+    };
+    std::vector<const AstNode *> pending{root};
+    while (!pending.empty()) {
+        const AstNode *node = pending.back();
+        pending.pop_back();
+        if (node == nullptr) {
+            mix("\0");
+            continue;
+        }
+        if (auto terminal = std::get_if<Terminal>(&node->sym)) {
+            mix(std::to_string(terminal->token.tokenType));
+            mix(terminal->token.value);
+        } else {
+            mix(std::get<Nonterminal>(node->sym).token);
+        }
+        mix(std::to_string(node->sonCnt));
+        ++nodes;
+        pending.push_back(node->brother);
+        pending.push_back(node->son);
+    }
+    return hash;
+}
+
+// Parses the input with the compressed table Grammar::gen() runs on, the
+// dense table it is packed from, and the nested std::map table they replaced.
+// gen() runs plain, with the ExprParser as CParser sets it up, with unit
+// collapsing, and with both. With PLUMA_DIRECT_PARSER, the generated direct-code
+// parser runs too. It carries out plain gen(), so its tree must hash the same
+// as that one; it is also timed against a CParser as shipped, whose tree it
+// does not build.
+bool parseBench(const std::string &filename, size_t repeat) {
+    std::string path = scaleProgram(filename, repeat);
+    double megabytes = (double)std::filesystem::file_size(path) / (1024.0 * 1024.0);
+    Lexer lexer(path);
+    TokenStream tokens = lexer.tokenize();
+
+    Stopwatch watch;
+    CParser parser;
+    double loadSeconds = watch.seconds();
+    Grammar &grammar = *parser.grammarPtr;
+    LR1_TableType mapTable = mapTableOf(grammar.table(), grammar.rules());
+    size_t mapBytes = mapTableMemory(mapTable);
+
+    size_t rounds = (2000000 + tokens.size() - 1) / tokens.size();
+    size_t parsed = rounds * tokens.size();
+    std::vector<uint32_t> mapReduced, denseReduced, compressedReduced;
+    bool mapAccepted = false, denseAccepted = false, compressedAccepted = false;
+
+    watch.restart();
+    for (size_t round = 0; round < rounds; ++round) {
+        mapReduced.clear();
+        mapAccepted = recognizeWithMap(mapTable, grammar.table().startState(), grammar.rules(),
+                                       tokens, mapReduced);
+    }
+    double mapSeconds = watch.seconds();
+
+    watch.restart();
+    for (size_t round = 0; round < rounds; ++round) {
+        denseReduced.clear();
+        denseAccepted = recognizeWithTable(grammar.table(), tokens, denseReduced);
+    }
+    double denseSeconds = watch.seconds();
+
+    watch.restart();
+    for (size_t round = 0; round < rounds; ++round) {
+        compressedReduced.clear();
+        compressedAccepted = recognizeWithTable(grammar.compressed(), tokens, compressedReduced);
+    }
+    double compressedSeconds = watch.seconds();
+
+    // Best of a few parses, each tree freed before the next parse: two of
+    // them may not fit. A parse into a fresh heap runs faster than one into
+    // a heap just freed, so an untimed parse goes first and the parsers take
+    // turns after it.
+    constexpr size_t treeRounds = 3;
+    struct TreeParse {
+        double seconds = 1e30;
+        uint64_t hash = 0;
+        size_t nodes = 0;
+        bool accepted = false;
+        Grammar::ParseStats steps;
+    };
+    auto timeTree = [&watch, &grammar](TreeParse &best, auto parse) {
+        watch.restart();
+        Ast ast = parse();
+        best.seconds = std::min(best.seconds, watch.seconds());
+        best.accepted = ast.head != nullptr;
+        best.hash = treeHash(ast.head, best.nodes);
+        best.steps = grammar.lastParseStats();
+    };
+    TreeParse gen, expr, unit, both;
+#ifdef PLUMA_DIRECT_PARSER
+    TreeParse direct, shipped;
+    CParser shippedParser;
+#endif
+    grammar.gen(tokens);
+    for (size_t round = 0; round < treeRounds; ++round) {
+        grammar.setExpressionParser(nullptr);
+        grammar.setUnitCollapsing(false);
+        timeTree(gen, [&] { return grammar.gen(tokens); });
+#ifdef PLUMA_DIRECT_PARSER
+        timeTree(direct, [&] { return cDirectParse(tokens); });
+        timeTree(shipped, [&] { return shippedParser.grammarPtr->gen(tokens); });
+#endif
+        grammar.setExpressionParser(&cExprParser());
+        timeTree(expr, [&] { return grammar.gen(tokens); });
+        grammar.setExpressionParser(nullptr);
+        grammar.setUnitCollapsing(true);
+        timeTree(unit, [&] { return grammar.gen(tokens); });
+        grammar.setExpressionParser(&cExprParser());
+        timeTree(both, [&] { return grammar.gen(tokens); });
+    }
+    double genSeconds = gen.seconds;
+
+    report("parse", "input", megabytes, "MB");
+    report("parse", "tokens", (double)tokens.size(), "tokens");
+    report("parse", "states", (double)grammar.table().states(), "states");
+    report("parse", "table-load", loadSeconds * 1e6, "us");
+    report("parse", "std::map-table", mapBytes / 1024.0, "KiB");
+    report("parse", "dense-table", grammar.table().memoryUsage() / 1024.0, "KiB");
+    report("parse", "compressed-table", grammar.compressed().memoryUsage() / 1024.0, "KiB");
+    report("parse", "std::map-drive", mapSeconds * 1e9 / parsed, "ns/token");
+    report("parse", "dense-drive", denseSeconds * 1e9 / parsed, "ns/token");
+    report("parse", "compressed-drive", compressedSeconds * 1e9 / parsed, "ns/token");
+    report("parse", "gen", genSeconds * 1e9 / tokens.size(), "ns/token");
+    report("parse", "gen-throughput", tokens.size() / genSeconds / 1e6, "Mtokens/s");
+    report("parse", "gen-bytes", megabytes / genSeconds, "MB/s");
+    report("parse", "gen-shifts", (double)gen.steps.shifts, "steps");
+    report("parse", "gen-reductions", (double)gen.steps.reductions, "steps");
+    report("parse", "gen-nodes", (double)gen.nodes, "nodes");
+    report("parse", "expr-gen", expr.seconds * 1e9 / tokens.size(), "ns/token");
+    report("parse", "expr-speedup", genSeconds / expr.seconds, "x");
+    report("parse", "expr-shifts", (double)expr.steps.shifts, "steps");
+    report("parse", "expr-reductions", (double)expr.steps.reductions, "steps");
+    report("parse", "expr-handoffs", (double)expr.steps.exprHandoffs, "exprs");
+    report("parse", "expr-nodes", (double)expr.nodes, "nodes");
+    report("parse", "unit-gen", unit.seconds * 1e9 / tokens.size(), "ns/token");
+    report("parse", "unit-speedup", genSeconds / unit.seconds, "x");
+    report("parse", "unit-reductions", (double)unit.steps.reductions, "steps");
+    report("parse", "unit-collapses", (double)unit.steps.unitCollapses, "steps");
+    report("parse", "unit-nodes", (double)unit.nodes, "nodes");
+    report("parse", "expr-unit-gen", both.seconds * 1e9 / tokens.size(), "ns/token");
+    report("parse", "expr-unit-speedup", genSeconds / both.seconds, "x");
+    report("parse", "expr-unit-reductions", (double)both.steps.reductions, "steps");
+    report("parse", "expr-unit-collapses", (double)both.steps.unitCollapses, "steps");
+    report("parse", "expr-unit-nodes", (double)both.nodes, "nodes");
+
+#ifdef PLUMA_DIRECT_PARSER
+    double directSeconds = direct.seconds;
+
+    report("parse", "direct", directSeconds * 1e9 / tokens.size(), "ns/token");
+    report("parse", "direct-throughput", tokens.size() / directSeconds / 1e6, "Mtokens/s");
+    report("parse", "direct-vs-plain-gen", genSeconds / directSeconds, "x");
+    report("parse", "direct-vs-cparser", shipped.seconds / directSeconds, "x");
+    if (direct.hash != gen.hash) {
+        std::cerr << "parse: the direct-code parser builds a different tree from plain gen()\n";
+        return false;
+    }
+#endif
+
+    bool same = mapAccepted == denseAccepted && mapReduced == denseReduced &&
+                compressedAccepted == denseAccepted && compressedReduced == denseReduced;
+    if (!same) {
+        std::cerr << "parse: the table layouts disagree\n";
+    }
+    if (!compressedAccepted || !gen.accepted || !expr.accepted || !unit.accepted ||
+        !both.accepted) {
+        std::cerr << "parse: input rejected\n";
+        same = false;
+    }
+    return same;
+}
+
+// Builds the C grammar's table with each construction, then checks that every
+// table parses the input with the same reductions.
+bool constructBench(const std::string &filename, size_t repeat) {
+    std::string path = scaleProgram(filename, repeat);
+    Lexer lexer(path);
+    TokenStream tokens = lexer.tokenize();
+
+    struct Mode {
+        const char *name;
+        Grammar::Construction construction;
+    };
+    const Mode modes[] = {
+        {"lr1", Grammar::Construction::LR1},
+        {"lalr1", Grammar::Construction::LALR1},
+    };
+
+    bool same = true;
+    std::vector<uint32_t> expected;
+    for (auto &mode : modes) {
+        resetPeakResident();
+        size_t residentBefore = residentKiB();
+        Grammar grammar("", cGrammarRules(), mode.construction, 1, cGrammarConflictPolicy());
+        // What construction peaked at, and what the grammar keeps after it.
+        double peak = (double)peakResidentKiB() - (double)residentBefore;
+        double retained = (double)residentKiB() - (double)residentBefore;
+
+        const ParseTable &table = grammar.table();
+        const Grammar::ConstructionStats &stats = grammar.constructionStats();
+        std::string suite = std::string("construct/") + mode.name;
+        report(suite, "states", (double)table.states(), "states");
+        report(suite, "table", table.memoryUsage() / 1024.0, "KiB");
+        report(suite, "build", stats.seconds * 1e3, "ms");
+        report(suite, "peak-rss", peak, "KiB");
+        report(suite, "retained-rss", retained, "KiB");
+        report(suite, "conflicts", (double)stats.conflicts, "cells");
+        report(suite, "merge-conflicts", (double)stats.mergeConflicts, "cells");
+
+        std::vector<uint32_t> reduced;
+        if (!recognizeWithTable(table, tokens, reduced)) {
+            std::cerr << "construct: " << mode.name << " table rejects the input\n";
+            same = false;
+        } else if (expected.empty()) {
+            expected = std::move(reduced);
+        } else if (reduced != expected) {
+            std::cerr << "construct: " << mode.name << " table parses differently\n";
+            same = false;
+        }
+
+        // Parallel builds must produce the very same image.
+        report(suite, "cores", (double)std::thread::hardware_concurrency(), "cores");
+        for (unsigned threads : {1u, 2u, 4u, 8u}) {
+            Grammar parallel("", cGrammarRules(), mode.construction, threads,
+                             cGrammarConflictPolicy());
+            const ParseTable &parallelTable = parallel.table();
+            double seconds = parallel.constructionStats().seconds;
+            report(suite, "threads-" + std::to_string(threads), seconds * 1e3, "ms");
+            report(suite, "speedup-" + std::to_string(threads), stats.seconds / seconds, "x");
+            if (parallelTable.memoryUsage() != table.memoryUsage() ||
+                memcmp(parallelTable.image(), table.image(), table.memoryUsage()) != 0) {
+                std::cerr << "construct: " << mode.name << " table differs on " << threads
+                          << " threads\n";
+                same = false;
+            }
+        }
+    }
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "Lexer.h"
+#include "bench/Bench.h"
+#include "utils/Simd.h"
+
+namespace pluma {
+
+namespace bench {
+
+// `lines` lines of code, each followed by a comment and a string literal of
+// the same byte length, either ASCII or CJK (three bytes per character).
+static std::string writeCommentedInput(const std::string &name, size_t lines, bool cjk) {
+    const std::string text = cjk ? "中文注释和字符串" : "ascii comment string";
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    for (size_t i = 0; i < lines; ++i) {
+        out << "char *s" << i << " = \"" << text << text << "\"; // " << text << text << text
+            << '\n';
+        if (i % 8 == 0) {
+            out << "/* " << text << '\n' << text << text << " */\n";
+        }
+    }
+    return path.string();
+}
+
+static bool validationAgrees(std::mt19937 &random) {
+    const std::vector<std::string> pieces{
+        "a", "int x;", "\n", "\xC2\xA9", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80", "\xED\x9F\xBF",
+        "\xF4\x8F\xBF\xBF",
+    };
+    const std::vector<std::string> invalid{
+        "\x80", "\xC0\x80", "\xC2", "\xE0\x80\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80",
+        "\xF8", "\xFF", "\xE4\xB8", "\xF0\x9F\x98",
+    };
+    for (size_t trial = 0; trial < 20000; ++trial) {
+        std::string input;
+        size_t length = std::uniform_int_distribution<size_t>(0, 160)(random);
+        while (input.size() < length) {
+            input += pieces[random() % pieces.size()];
+        }
+        if (trial % 2 == 1) {
+            size_t at = input.empty() ? 0 : random() % input.size();
+            input.insert(at, invalid[random() % invalid.size()]);
+        }
+        const char *begin = input.data(), *end = begin + input.size();
+
+        utils::setSimdLevel(utils::SimdLevel::SCALAR);
+        const char *expected = utils::validateUtf8(begin, end);
+        for (int level = (int)utils::SimdLevel::SSE2; level <= (int)utils::maxSimdLevel();
+             ++level) {
+            utils::setSimdLevel((utils::SimdLevel)level);
+            if (utils::validateUtf8(begin, end) != expected) {
+                std::cerr << "utf8: " << utils::simdLevelName((utils::SimdLevel)level)
+                          << " disagrees with scalar on trial " << trial << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Validation throughput per kernel level, and lexing throughput on inputs with
+// ASCII and with CJK comments and strings.
+bool utf8Bench(const std::string &filename, size_t repeat) {
+    std::mt19937 random(7);
+    utils::SimdLevel defaultLevel = utils::simdLevel();
+    bool same = validationAgrees(random);
+
+    size_t lines = 20000 * repeat;
+    std::string asciiPath = writeCommentedInput("pluma_bench_ascii.c", lines, false);
+    std::string cjkPath = writeCommentedInput("pluma_bench_cjk.c", lines, true);
+    std::string samplePath = scaleInput(filename, repeat * 100);
+
+    for (auto &[name, path] : {std::pair{"ascii", asciiPath}, std::pair{"cjk", cjkPath},
+                               std::pair{"input", samplePath}}) {
+        utils::SourceBuffer buffer;
+        buffer.open(path);
+        double megabytes = (double)buffer.size() / (1024.0 * 1024.0);
+
+        for (int level = (int)utils::SimdLevel::SCALAR; level <= (int)utils::maxSimdLevel();
+             ++level) {
+            utils::setSimdLevel((utils::SimdLevel)level);
+            Stopwatch watch;
+            size_t rounds = 10;
+            for (size_t round = 0; round < rounds; ++round) {
+                if (utils::validateUtf8(buffer.begin(), buffer.end()) != buffer.end()) {
+                    std::cerr << "utf8: " << name << " input reported as invalid\n";
+                    same = false;
+                }
+            }
+            report("utf8", std::string("validate-") + name + "-" +
+                               utils::simdLevelName((utils::SimdLevel)level),
+                   megabytes * rounds / watch.seconds(), "MB/s");
+        }
+        utils::setSimdLevel(defaultLevel);
+
+        Stopwatch watch;
+        Lexer lexer(path);
+        TokenStream tokens = lexer.tokenize();
+        report("utf8", std::string("lex-") + name, megabytes / watch.seconds(), "MB/s");
+    }
+    utils::setSimdLevel(defaultLevel);
+    return same;
+}
+
+}  // namespace bench
+
+}  // namespace pluma
@@ -14,15 +14,25 @@ void panic(const char *info) {
 int main(int argc, char *argv[]) {
     int opt;
     std::string inputFilename, outputFilename;
+    bool trace = false;
+    bool collapseUnits = false;
 
-    while ((opt = getopt(argc, argv, "o:")) != -1) {
+    while ((opt = getopt(argc, argv, "o:tu")) != -1) {
         switch (opt) {
             case 'o':
                 outputFilename = optarg;
                 // std::cout << "-o:" << optarg << std::endl;
                 break;
+            case 't':
+                // Log every parser action to log.txt.
+                trace = true;
+                break;
+            case 'u':
+                // Collapse unit reductions into the node below; same output.
+                collapseUnits = true;
+                break;
             default: /* '?' */
-                fprintf(stderr, "Usage: %s [-o output_file]  input_file\n", argv[0]);
+                fprintf(stderr, "Usage: %s [-t] [-u] [-o output_file]  input_file\n", argv[0]);
                 exit(EXIT_FAILURE);
         }
     }
@@ -33,18 +43,20 @@ int main(int argc, char *argv[]) {
     }
 
     inputFilename = argv[optind];
+    openLog("../../log.txt");
 
     pluma::Lexer lexer(inputFilename);
-    std::vector<pluma::Sym> symVec = lexer.tokenize();
+    pluma::TokenStream tokens = lexer.tokenizeParallel();
 
     std::unique_ptr<pluma::Parser> cParserPtr = std::make_unique<pluma::CParser>(pluma::CParser());
     cParserPtr->grammarPtr->displayAllRule();
-    cParserPtr->grammarPtr->checkLR1();
-    pluma::Ast ast = cParserPtr->grammarPtr->gen(symVec);
+    cParserPtr->grammarPtr->setTrace(trace);
+    cParserPtr->grammarPtr->setUnitCollapsing(collapseUnits);
+    pluma::Ast ast = cParserPtr->grammarPtr->gen(tokens);
     ast.display();
 
     pluma::Formatter formatter(outputFilename);
-    formatter.format(ast);
+    formatter.format(ast, tokens, cParserPtr->grammarPtr->rules());
 
     return 0;
 }
\ No newline at end of file
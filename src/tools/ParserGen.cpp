@@ -0,0 +1,280 @@
+// Compiles the LR automaton of the C grammar into C++ source defining
+// cDirectParse(): a label per reachable state that switches on the lookahead token
+// type, a label per rule with its reduction written out, and a label per
+// nonterminal that switches on the exposed state for the GOTO.
+//
+//     parsergen <output.cpp>
+//
+// The actions are read from the compressed table Grammar::gen() runs on, so
+// the generated parser takes the very same steps, default reductions
+// included, and builds the same Ast as plain gen(), without an ExprParser or
+// unit collapsing. CParser turns its ExprParser on, so its Ast differs.
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "c/CParser.h"
+
+void panic(const char *info) {
+    std::cerr << "\nError: " << info << std::endl;
+    std::abort();
+}
+
+namespace {
+
+using pluma::CompressedParseTable;
+using pluma::ParseTable;
+using pluma::TokenType;
+
+const char *const tokenNames[] = {
+    "TK_EOF",
+#define PLUMA_TOKEN(name) #name,
+#define PLUMA_PREFIX(name, spelling) #name,
+#define PLUMA_PUNCT(name, spelling) #name,
+#define PLUMA_KEYWORD(name, spelling) #name,
+#include "TokenSpec.def"
+};
+
+std::string caseLabel(TokenType type) {
+    return std::string("case TokenType::") + tokenNames[ParseTable::terminalId(type)] + ":";
+}
+
+// The jump that carries out `action`; fills the sets of labels it needs.
+std::string jumpTo(ParseTable::Word action, bool isEpsilon, std::set<size_t> &shifts,
+                   std::set<size_t> &epsilons, std::set<size_t> &reductions) {
+    size_t target = ParseTable::targetOf(action);
+    switch (ParseTable::kindOf(action)) {
+        case ParseTable::Kind::PUSH_STACK: {
+            (isEpsilon ? epsilons : shifts).insert(target);
+            return (isEpsilon ? "goto epsilon_" : "goto shift_") + std::to_string(target) + ";";
+        }
+        case ParseTable::Kind::REDUCE: {
+            reductions.insert(target);
+            return "goto reduce_" + std::to_string(target) + ";";
+        }
+        case ParseTable::Kind::ACCEPT: {
+            return "goto accept;";
+        }
+        case ParseTable::Kind::ERROR: {
+            break;
+        }
+    }
+    return "goto error;";
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output.cpp>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    pluma::CParser parser;
+    const pluma::Grammar &grammar = *parser.grammarPtr;
+    const CompressedParseTable &table = grammar.compressed();
+    const ParseTable &dense = grammar.table();
+    const std::vector<pluma::Rule> &rules = grammar.rules();
+
+    // Nonterminal names by GOTO column.
+    std::vector<std::string> names(dense.nonterminals());
+    for (size_t rule = 0; rule < rules.size(); ++rule) {
+        names[table.ruleLhs(rule)] = rules[rule].first.token;
+    }
+
+    // Code is written only for the states a parse can reach from the start
+    // state, so every label in the output is jumped to.
+    std::set<size_t> shifts, epsilons, reductions;
+    // The GOTO columns reduced to.
+    std::set<size_t> nonterminals;
+    std::vector<std::string> stateCode(table.states());
+    std::vector<bool> reached(table.states());
+    std::vector<size_t> pending{table.startState()};
+    reached[table.startState()] = true;
+    auto reach = [&reached, &pending](size_t state) {
+        if (!reached[state]) {
+            reached[state] = true;
+            pending.push_back(state);
+        }
+    };
+    while (!pending.empty()) {
+        size_t state = pending.back();
+        pending.pop_back();
+        std::string &code = stateCode[state];
+        // Terminals by the action they take, in token order.
+        std::map<ParseTable::Word, std::vector<TokenType>> cases;
+        for (int type = TokenType::TK_EOF; type + 1 < (int)pluma::tokenTypeCount; ++type) {
+            ParseTable::Word action = table.action(state, (TokenType)type);
+            if (ParseTable::kindOf(action) != ParseTable::Kind::ERROR) {
+                cases[action].push_back((TokenType)type);
+            }
+        }
+        std::set<size_t> stateShifts, stateEpsilons, stateReductions;
+        code += "state_" + std::to_string(state) + ":\n";
+        code += "    switch (tokens.type(pos)) {\n";
+        for (auto &[action, types] : cases) {
+            for (TokenType type : types) {
+                code += "        " + caseLabel(type) + "\n";
+            }
+            code += "            " +
+                    jumpTo(action, false, stateShifts, stateEpsilons, stateReductions) + "\n";
+        }
+        code += "        default:\n";
+        code += "            " +
+                jumpTo(table.epsilonAction(state), true, stateShifts, stateEpsilons,
+                       stateReductions) +
+                "\n";
+        code += "    }\n\n";
+
+        for (size_t target : stateShifts) {
+            shifts.insert(target);
+            reach(target);
+        }
+        for (size_t target : stateEpsilons) {
+            epsilons.insert(target);
+            reach(target);
+        }
+        for (size_t rule : stateReductions) {
+            reductions.insert(rule);
+            // The GOTO switch jumps to every target of the column.
+            if (nonterminals.insert(table.ruleLhs(rule)).second) {
+                for (size_t from = 0; from < dense.states(); ++from) {
+                    ParseTable::Word target = dense.gotoState(from, table.ruleLhs(rule));
+                    if (target != ParseTable::noState) {
+                        reach(target);
+                    }
+                }
+            }
+        }
+    }
+    std::string states;
+    for (auto &code : stateCode) {
+        states += code;
+    }
+
+    FILE *out = fopen(argv[1], "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    fprintf(out, "// Generated by parsergen from the C parse table; do not edit.\n");
+    fprintf(out, "// %zu states, %zu rules.\n\n", table.states(), rules.size());
+    fprintf(out, "#include \"c/CDirectParser.h\"\n\n#include <iostream>\n#include <vector>\n\n");
+    fprintf(out, "namespace pluma {\n\n");
+    fprintf(out, "// Copied into the nodes, by GOTO column.\n");
+    fprintf(out, "static const Nonterminal nonterminals[] = {\n");
+    for (auto &name : names) {
+        fprintf(out, "    Nonterminal{\"%s\"},\n", name.c_str());
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "Ast cDirectParse(const TokenStream &tokens) {\n");
+    fprintf(out, "    if (tokens.empty()) {\n        return Ast(nullptr);\n    }\n");
+    fprintf(out, "    std::vector<uint32_t> states;\n");
+    fprintf(out, "    std::vector<AstNode *> nodes;\n");
+    fprintf(out, "    states.reserve(tokens.size() + 1);\n");
+    fprintf(out, "    nodes.reserve(tokens.size() + 1);\n");
+    fprintf(out, "    size_t pos = 0;\n");
+    fprintf(out, "    AstNode *node = nullptr;\n\n");
+    fprintf(out, "    states.push_back(%zu);\n    goto state_%zu;\n\n", table.startState(),
+            table.startState());
+    fputs(states.c_str(), out);
+
+    for (size_t target : shifts) {
+        fprintf(out, "shift_%zu:\n", target);
+        fprintf(out, "    states.push_back(%zu);\n", target);
+        fprintf(out, "    nodes.push_back(new AstNode(Terminal{tokens.token(pos++)}));\n");
+        fprintf(out, "    goto state_%zu;\n\n", target);
+    }
+    for (size_t target : epsilons) {
+        fprintf(out, "epsilon_%zu:\n", target);
+        fprintf(out, "    states.push_back(%zu);\n", target);
+        fprintf(out, "    nodes.push_back(nullptr);\n");
+        fprintf(out, "    goto state_%zu;\n\n", target);
+    }
+
+    for (size_t rule : reductions) {
+        size_t length = table.ruleLength(rule);
+        std::string text = rules[rule].first.token + " ->";
+        for (auto &sym : rules[rule].second) {
+            if (auto terminal = std::get_if<pluma::Terminal>(&sym)) {
+                text += " " + std::string(terminal->token.value);
+            } else {
+                text += " " + std::get<pluma::Nonterminal>(sym).token;
+            }
+        }
+        fprintf(out, "    // %s\n", text.c_str());
+        fprintf(out, "reduce_%zu:\n", rule);
+        fprintf(out, "    node = new AstNode(nonterminals[%zu]);\n", table.ruleLhs(rule));
+        for (size_t i = length; i > 0; --i) {
+            fprintf(out, "    node->appendSon(nodes[nodes.size() - %zu]);\n", i);
+        }
+        if (length != 0) {
+            fprintf(out, "    nodes.resize(nodes.size() - %zu);\n", length);
+            fprintf(out, "    states.resize(states.size() - %zu);\n", length);
+        }
+        fprintf(out, "    goto goto_%zu;\n\n", table.ruleLhs(rule));
+    }
+
+    for (size_t nonterminal : nonterminals) {
+        // States by GOTO target; the most common target is the default.
+        std::map<size_t, std::vector<size_t>> targets;
+        for (size_t state = 0; state < dense.states(); ++state) {
+            ParseTable::Word target = dense.gotoState(state, nonterminal);
+            if (target != ParseTable::noState) {
+                targets[target].push_back(state);
+            }
+        }
+        size_t defaultTarget = SIZE_MAX;
+        for (auto &[target, states] : targets) {
+            if (defaultTarget == SIZE_MAX || states.size() > targets[defaultTarget].size()) {
+                defaultTarget = target;
+            }
+        }
+        fprintf(out, "    // %s\n", names[nonterminal].c_str());
+        fprintf(out, "goto_%zu:\n", nonterminal);
+        fprintf(out, "    nodes.push_back(node);\n");
+        fprintf(out, "    switch (states.back()) {\n");
+        for (auto &[target, states] : targets) {
+            if (target == defaultTarget) {
+                continue;
+            }
+            for (size_t state : states) {
+                fprintf(out, "        case %zu:\n", state);
+            }
+            fprintf(out, "            states.push_back(%zu);\n", target);
+            fprintf(out, "            goto state_%zu;\n", target);
+        }
+        fprintf(out, "        default:\n");
+        if (defaultTarget == SIZE_MAX) {
+            fprintf(out, "            goto error;\n");
+        } else {
+            fprintf(out, "            states.push_back(%zu);\n", defaultTarget);
+            fprintf(out, "            goto state_%zu;\n", defaultTarget);
+        }
+        fprintf(out, "    }\n\n");
+    }
+
+    fprintf(out, "accept:\n");
+    fprintf(out, "    if (nodes.size() != 1) {\n        return Ast(nullptr);\n    }\n");
+    fprintf(out, "    return Ast(nodes.back());\n\n");
+    fprintf(out, "error:\n");
+    fprintf(out, "    utils::SourcePosition position = tokens.position(pos);\n");
+    fprintf(out, "    std::cerr << \"\\nERROR: state \" << states.back() << \", symbol \"\n");
+    fprintf(out, "              << (tokens.type(pos) == TokenType::TK_EOF ? \"<eof>\" "
+                 ": tokens.text(pos))\n");
+    fprintf(out, "              << \" have an error action.\\n\";\n");
+    fprintf(out, "    std::cerr << \"At line \" << position.line << \", column \" "
+                 "<< position.column\n");
+    fprintf(out, "              << std::endl;\n");
+    fprintf(out, "    return Ast(nullptr);\n");
+    fprintf(out, "}\n\n}  // namespace pluma\n");
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Cannot write %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
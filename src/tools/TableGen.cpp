@@ -0,0 +1,66 @@
+// Builds the parse table of the C grammar and writes it out as a C++ source
+// defining cParseTableImage, so `main` starts without building or loading it.
+//
+//     tablegen <output.cpp> <cache.bin> <log.txt>
+//
+// The cache keeps the table between builds; it is rebuilt whenever the rules,
+// Grammar::constructionVersion or ParseTable::formatVersion change.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Grammar.hpp"
+#include "c/CGrammar.h"
+
+void panic(const char *info) {
+    std::cerr << "\nError: " << info << std::endl;
+    std::abort();
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        fprintf(stderr, "Usage: %s <output.cpp> <cache.bin> <log.txt>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // It runs in the build tree; the log goes where the build says.
+    openLog(argv[3]);
+
+    pluma::Grammar grammar(argv[2], pluma::cGrammarRules(), pluma::cGrammarConstruction, 0,
+                           pluma::cGrammarConflictPolicy());
+    const pluma::ParseTable &table = grammar.table();
+    if (!table.isMapped()) {
+        const pluma::Grammar::ConstructionStats &stats = grammar.constructionStats();
+        printf("tablegen: built %zu states (%zu KiB) in %.2f s; %zu conflicts, %zu from merging\n",
+               table.states(), table.memoryUsage() / 1024, stats.seconds, stats.conflicts,
+               stats.mergeConflicts);
+    }
+
+    std::vector<uint64_t> words((table.memoryUsage() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    memcpy(words.data(), table.image(), table.memoryUsage());
+
+    FILE *out = fopen(argv[1], "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    fprintf(out, "// Generated by tablegen from cGrammarRules(); do not edit.\n");
+    fprintf(out, "// %zu states, %zu nonterminals, %zu rules.\n\n", table.states(),
+            table.nonterminals(), table.rules());
+    fprintf(out, "#include \"c/CParseTable.h\"\n\nnamespace pluma {\n\n");
+    fprintf(out, "alignas(8) extern constexpr uint64_t cParseTableImage[] = {\n");
+    for (size_t i = 0; i < words.size(); ++i) {
+        fprintf(out, "%s0x%016" PRIx64 ",%s", i % 4 == 0 ? "    " : "", words[i],
+                i % 4 == 3 || i + 1 == words.size() ? "\n" : " ");
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "extern constexpr size_t cParseTableWords = %zu;\n\n", words.size());
+    fprintf(out, "}  // namespace pluma\n");
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Cannot write %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
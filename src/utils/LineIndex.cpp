@@ -0,0 +1,35 @@
+#include "utils/LineIndex.h"
+
+#include <algorithm>
+
+#include "utils/Simd.h"
+
+namespace pluma {
+
+namespace utils {
+
+LineIndex::LineIndex(const char *begin, const char *end) : bytes(begin), length(end - begin) {
+    // Source code averages a few dozen bytes per line.
+    this->starts.reserve(this->length / 32 + 1);
+    this->starts.push_back(0);
+    appendLineStarts(begin, end, 0, this->starts);
+}
+
+size_t LineIndex::line(size_t offset) const {
+    return std::upper_bound(this->starts.begin(), this->starts.end(), (uint32_t)offset) -
+           this->starts.begin();
+}
+
+SourcePosition LineIndex::position(size_t offset) const {
+    size_t line = this->line(offset);
+    size_t column = 1;
+    offset = std::min(offset, this->length);
+    for (size_t i = this->starts[line - 1]; i < offset; ++i) {
+        column += ((uint8_t)this->bytes[i] & 0xC0) != 0x80;
+    }
+    return SourcePosition{line, column};
+}
+
+}  // namespace utils
+
+}  // namespace pluma
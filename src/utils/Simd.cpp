@@ -0,0 +1,558 @@
+#include "utils/Simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PLUMA_SIMD_X86 1
+#endif
+
+namespace pluma {
+
+namespace utils {
+
+namespace {
+
+inline bool isBlankByte(char c) {
+    return c == ' ' || (unsigned char)(c - '\t') <= (unsigned char)('\r' - '\t');
+}
+
+inline bool isIdentifierByte(char c) {
+    return (unsigned char)((c | 0x20) - 'a') < 26 || (unsigned char)(c - '0') < 10 || c == '_';
+}
+
+inline bool isStringSpecialByte(char c) { return c == '\"' || c == '\\' || c == '\n'; }
+
+// Scalar kernels; also used for the tails the vector kernels leave behind.
+
+const char *skipBlanksScalar(const char *p, const char *end) {
+    while (p < end && isBlankByte(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char *skipIdentifierScalar(const char *p, const char *end) {
+    while (p < end && isIdentifierByte(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char *findBlockCommentEndScalar(const char *p, const char *end) {
+    for (; p + 1 < end; ++p) {
+        if (p[0] == '*' && p[1] == '/') {
+            return p;
+        }
+    }
+    return end;
+}
+
+void appendLineStartsScalar(const char *p, const char *end, uint32_t base,
+                            std::vector<uint32_t> &starts) {
+    for (const char *begin = p; (p = (const char *)memchr(p, '\n', end - p)) != nullptr;) {
+        ++p;
+        starts.push_back(base + (uint32_t)(p - begin));
+    }
+}
+
+const char *findStringSpecialScalar(const char *p, const char *end) {
+    while (p < end && !isStringSpecialByte(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// End of the well-formed UTF-8 sequence (RFC 3629: no overlongs, surrogates or
+// code points above U+10FFFF) starting with a non-ASCII byte at `p`, or nullptr.
+inline const char *utf8Sequence(const char *p, const char *end) {
+    auto lead = (uint8_t)*p;
+    ptrdiff_t length;
+    uint8_t low = 0x80, high = 0xBF;  // range of the second byte
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        low = lead == 0xE0 ? 0xA0 : low;
+        high = lead == 0xED ? 0x9F : high;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        low = lead == 0xF0 ? 0x90 : low;
+        high = lead == 0xF4 ? 0x8F : high;
+    } else {
+        return nullptr;
+    }
+    if (end - p < length || (uint8_t)p[1] < low || (uint8_t)p[1] > high) {
+        return nullptr;
+    }
+    for (ptrdiff_t i = 2; i < length; ++i) {
+        if (((uint8_t)p[i] & 0xC0) != 0x80) {
+            return nullptr;
+        }
+    }
+    return p + length;
+}
+
+const char *validateUtf8Scalar(const char *p, const char *end) {
+    while (p < end) {
+        // Eight ASCII bytes at a time.
+        uint64_t word;
+        if (end - p >= 8 && (memcpy(&word, p, 8), (word & 0x8080808080808080ull) == 0)) {
+            p += 8;
+            continue;
+        }
+        if ((uint8_t)*p < 0x80) {
+            ++p;
+            continue;
+        }
+        const char *next = utf8Sequence(p, end);
+        if (next == nullptr) {
+            return p;
+        }
+        p = next;
+    }
+    return end;
+}
+
+#ifdef PLUMA_SIMD_X86
+
+// SSE2: 16 bytes per step.
+
+__attribute__((target("sse2"))) inline __m128i blankMask128(__m128i x) {
+    // ' ' or '\t'..'\r' (unsigned x - '\t' <= 4).
+    __m128i shifted = _mm_sub_epi8(x, _mm_set1_epi8('\t'));
+    __m128i isCtrl = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+    return _mm_or_si128(isCtrl, _mm_cmpeq_epi8(x, _mm_set1_epi8(' ')));
+}
+
+__attribute__((target("sse2"))) const char *skipBlanksSse2(const char *p, const char *end) {
+    for (; p + 16 <= end; p += 16) {
+        uint32_t blank =
+            (uint32_t)_mm_movemask_epi8(blankMask128(_mm_loadu_si128((const __m128i *)p)));
+        if (blank != 0xFFFF) {
+            return p + __builtin_ctz(~blank);
+        }
+    }
+    return skipBlanksScalar(p, end);
+}
+
+__attribute__((target("sse2"))) const char *skipIdentifierSse2(const char *p, const char *end) {
+    for (; p + 16 <= end; p += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)p);
+        __m128i alpha = _mm_sub_epi8(_mm_or_si128(x, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(25)), alpha);
+        __m128i digit = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+        __m128i isUnderscore = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+        uint32_t ident =
+            (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(isAlpha, isDigit), isUnderscore));
+        if (ident != 0xFFFF) {
+            return p + __builtin_ctz(~ident);
+        }
+    }
+    return skipIdentifierScalar(p, end);
+}
+
+__attribute__((target("sse2"))) const char *findBlockCommentEndSse2(const char *p,
+                                                                     const char *end) {
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+    // Needs one byte of look-ahead for the '/'.
+    for (; p + 17 <= end; p += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)p);
+        __m128i next = _mm_loadu_si128((const __m128i *)(p + 1));
+        uint32_t close = (uint32_t)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(x, star), _mm_cmpeq_epi8(next, slash)));
+        if (close != 0) {
+            return p + __builtin_ctz(close);
+        }
+    }
+    return findBlockCommentEndScalar(p, end);
+}
+
+__attribute__((target("sse2"))) void appendLineStartsSse2(const char *p, const char *end,
+                                                          uint32_t base,
+                                                          std::vector<uint32_t> &starts) {
+    const char *begin = p;
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; p + 16 <= end; p += 16) {
+        auto lines = (uint32_t)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), nl));
+        for (; lines != 0; lines &= lines - 1) {
+            starts.push_back(base + (uint32_t)(p - begin) + __builtin_ctz(lines) + 1);
+        }
+    }
+    appendLineStartsScalar(p, end, base + (uint32_t)(p - begin), starts);
+}
+
+__attribute__((target("sse2"))) const char *findStringSpecialSse2(const char *p,
+                                                                   const char *end) {
+    for (; p + 16 <= end; p += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)p);
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\"')),
+                         _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))),
+            _mm_cmpeq_epi8(x, _mm_set1_epi8('\n')));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(special);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return findStringSpecialScalar(p, end);
+}
+
+// Skips all-ASCII blocks of 16 bytes; characters in other blocks are checked
+// one by one.
+__attribute__((target("sse2"))) const char *validateUtf8Sse2(const char *p, const char *end) {
+    while (p + 16 <= end) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p)) == 0) {
+            p += 16;
+            continue;
+        }
+        for (const char *blockEnd = p + 16; p < blockEnd;) {
+            if ((uint8_t)*p < 0x80) {
+                ++p;
+                continue;
+            }
+            const char *next = utf8Sequence(p, end);
+            if (next == nullptr) {
+                return p;
+            }
+            p = next;
+        }
+    }
+    return validateUtf8Scalar(p, end);
+}
+
+// AVX2: 32 bytes per step, same classification as above.
+
+__attribute__((target("avx2"))) inline __m256i blankMask256(__m256i x) {
+    __m256i shifted = _mm256_sub_epi8(x, _mm256_set1_epi8('\t'));
+    __m256i isCtrl =
+        _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+    return _mm256_or_si256(isCtrl, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2"))) const char *skipBlanksAvx2(const char *p, const char *end) {
+    for (; p + 32 <= end; p += 32) {
+        uint32_t blank = (uint32_t)_mm256_movemask_epi8(
+            blankMask256(_mm256_loadu_si256((const __m256i *)p)));
+        if (blank != 0xFFFFFFFFu) {
+            return p + __builtin_ctz(~blank);
+        }
+    }
+    return skipBlanksSse2(p, end);
+}
+
+__attribute__((target("avx2"))) const char *skipIdentifierAvx2(const char *p, const char *end) {
+    for (; p + 32 <= end; p += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)p);
+        __m256i alpha =
+            _mm256_sub_epi8(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i isAlpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(25)), alpha);
+        __m256i digit = _mm256_sub_epi8(x, _mm256_set1_epi8('0'));
+        __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+        __m256i isUnderscore = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'));
+        uint32_t ident = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_or_si256(isAlpha, isDigit), isUnderscore));
+        if (ident != 0xFFFFFFFFu) {
+            return p + __builtin_ctz(~ident);
+        }
+    }
+    return skipIdentifierSse2(p, end);
+}
+
+__attribute__((target("avx2"))) const char *findBlockCommentEndAvx2(const char *p,
+                                                                     const char *end) {
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+    for (; p + 33 <= end; p += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)p);
+        __m256i next = _mm256_loadu_si256((const __m256i *)(p + 1));
+        uint32_t close = (uint32_t)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(x, star), _mm256_cmpeq_epi8(next, slash)));
+        if (close != 0) {
+            return p + __builtin_ctz(close);
+        }
+    }
+    return findBlockCommentEndSse2(p, end);
+}
+
+__attribute__((target("avx2"))) void appendLineStartsAvx2(const char *p, const char *end,
+                                                          uint32_t base,
+                                                          std::vector<uint32_t> &starts) {
+    const char *begin = p;
+    const __m256i nl = _mm256_set1_epi8('\n');
+    for (; p + 32 <= end; p += 32) {
+        auto lines = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), nl));
+        for (; lines != 0; lines &= lines - 1) {
+            starts.push_back(base + (uint32_t)(p - begin) + __builtin_ctz(lines) + 1);
+        }
+    }
+    appendLineStartsSse2(p, end, base + (uint32_t)(p - begin), starts);
+}
+
+__attribute__((target("avx2"))) const char *findStringSpecialAvx2(const char *p,
+                                                                   const char *end) {
+    for (; p + 32 <= end; p += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)p);
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\"')),
+                            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))),
+            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(special);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return findStringSpecialSse2(p, end);
+}
+
+// UTF-8 validation by table lookups on nibbles (Keiser and Lemire, "Validating
+// UTF-8 in less than one instruction per byte"): each byte is checked against
+// the one to three bytes before it, 32 bytes at a time, with no branches on
+// the data. Each error class below is a bit; a pair of bytes is invalid if the
+// three lookups agree on some bit.
+namespace utf8 {
+
+constexpr uint8_t tooShort = 1 << 0;    // 11______ 0_______
+constexpr uint8_t tooLong = 1 << 1;     // 0_______ 10______
+constexpr uint8_t overlong3 = 1 << 2;   // 11100000 100_____
+constexpr uint8_t tooLarge = 1 << 3;    // 11110100 1001____
+constexpr uint8_t surrogate = 1 << 4;   // 11101101 101_____
+constexpr uint8_t overlong2 = 1 << 5;   // 1100000_ 10______
+constexpr uint8_t tooLarge1000 = 1 << 6;  // 11110101 1000____
+constexpr uint8_t overlong4 = 1 << 6;   // 11110000 1000____
+constexpr uint8_t twoConts = 1 << 7;    // 10______ 10______
+constexpr uint8_t carry = tooShort | tooLong | twoConts;
+
+}  // namespace utf8
+
+// Input shifted right by N bytes across the previous block.
+template <int N>
+__attribute__((target("avx2"))) inline __m256i previousBytes(__m256i input, __m256i previous) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2"))) inline __m256i highNibbles(__m256i x) {
+    return _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0F));
+}
+
+__attribute__((target("avx2"))) inline __m256i utf8Errors(__m256i input, __m256i previous) {
+    using namespace utf8;
+    const __m256i byte1HighTable = _mm256_setr_epi8(
+        // 0_______: ASCII
+        tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong,
+        // 10______: continuation
+        twoConts, twoConts, twoConts, twoConts,
+        // 1100____, 1101____: two-byte lead
+        tooShort | overlong2, tooShort,
+        // 1110____: three-byte lead
+        tooShort | overlong3 | surrogate,
+        // 1111____: four-byte lead
+        tooShort | tooLarge | tooLarge1000 | overlong4,
+        // Same table for the upper lane.
+        tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, twoConts,
+        twoConts, twoConts, twoConts, tooShort | overlong2, tooShort,
+        tooShort | overlong3 | surrogate, tooShort | tooLarge | tooLarge1000 | overlong4);
+    constexpr char large = carry | tooLarge | tooLarge1000;
+    const __m256i byte1LowTable = _mm256_setr_epi8(
+        // ____0000, ____0001
+        carry | overlong3 | overlong2 | overlong4, carry | overlong2,
+        // ____001_
+        carry, carry,
+        // ____0100
+        carry | tooLarge,
+        // ____0101 .. ____1100
+        large, large, large, large, large, large, large, large,
+        // ____1101
+        large | surrogate,
+        // ____111_
+        large, large,
+        // Same table for the upper lane.
+        carry | overlong3 | overlong2 | overlong4, carry | overlong2, carry, carry,
+        carry | tooLarge, large, large, large, large, large, large, large, large,
+        large | surrogate, large, large);
+    constexpr char cont1000 = tooLong | overlong2 | twoConts | overlong3 | tooLarge1000 | overlong4;
+    constexpr char cont1001 = tooLong | overlong2 | twoConts | overlong3 | tooLarge;
+    constexpr char cont101 = tooLong | overlong2 | twoConts | surrogate | tooLarge;
+    const __m256i byte2HighTable = _mm256_setr_epi8(
+        // ________ 0_______: ASCII
+        tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort,
+        // ________ 1000____, 1001____, 101_____
+        cont1000, cont1001, cont101, cont101,
+        // ________ 11______
+        tooShort, tooShort, tooShort, tooShort,
+        // Same table for the upper lane.
+        tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort,
+        cont1000, cont1001, cont101, cont101, tooShort, tooShort, tooShort, tooShort);
+
+    __m256i prev1 = previousBytes<1>(input, previous);
+    __m256i special = _mm256_and_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(byte1HighTable, highNibbles(prev1)),
+                         _mm256_shuffle_epi8(byte1LowTable,
+                                             _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)))),
+        _mm256_shuffle_epi8(byte2HighTable, highNibbles(input)));
+
+    // The second and third continuation bytes of 3- and 4-byte sequences;
+    // "special" has twoConts set exactly there when the input is valid.
+    __m256i isThird = _mm256_subs_epu8(previousBytes<2>(input, previous),
+                                       _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i isFourth = _mm256_subs_epu8(previousBytes<3>(input, previous),
+                                        _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i mustBeContinuation =
+        _mm256_and_si256(_mm256_or_si256(isThird, isFourth), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(mustBeContinuation, special);
+}
+
+// Non-zero where the block ends inside a multi-byte sequence.
+__attribute__((target("avx2"))) inline __m256i utf8Incomplete(__m256i input) {
+    const __m256i maxValue = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    return _mm256_subs_epu8(input, maxValue);
+}
+
+// Checks one block; returns true if an error was found.
+__attribute__((target("avx2"))) inline bool utf8Step(__m256i input, __m256i &previous,
+                                                     __m256i &incomplete) {
+    __m256i error;
+    if (_mm256_movemask_epi8(input) == 0) {
+        // All ASCII: only an unfinished sequence before it can be wrong.
+        error = incomplete;
+        incomplete = _mm256_setzero_si256();
+    } else {
+        // Sequences running in from the previous block are checked here too.
+        error = utf8Errors(input, previous);
+        incomplete = utf8Incomplete(input);
+    }
+    previous = input;
+    return _mm256_testz_si256(error, error) == 0;
+}
+
+__attribute__((target("avx2"))) const char *validateUtf8Avx2(const char *p, const char *end) {
+    const char *begin = p;
+    __m256i previous = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    for (; p + 32 <= end; p += 32) {
+        if (utf8Step(_mm256_loadu_si256((const __m256i *)p), previous, incomplete)) {
+            break;
+        }
+    }
+    if (p + 32 > end) {
+        // The zero padding is ASCII, so a sequence cut off by the end shows up.
+        alignas(32) char tail[32] = {};
+        memcpy(tail, p, end - p);
+        if (!utf8Step(_mm256_load_si256((const __m256i *)tail), previous, incomplete)) {
+            return end;
+        }
+    }
+    // Something in this block, or a sequence running into it, is wrong. The
+    // bytes before are fine, so rescan from the start of the last character
+    // that begins within three bytes before the block.
+    p = p - begin >= 3 ? p - 3 : begin;
+    for (int i = 0; i < 3 && p > begin && ((uint8_t)*p & 0xC0) == 0x80; ++i) {
+        --p;
+    }
+    return validateUtf8Scalar(p, end);
+}
+
+#endif  // PLUMA_SIMD_X86
+
+struct Kernels {
+    SimdLevel level;
+    const char *(*skipBlanks)(const char *, const char *);
+    const char *(*skipIdentifier)(const char *, const char *);
+    const char *(*findBlockCommentEnd)(const char *, const char *);
+    const char *(*findStringSpecial)(const char *, const char *);
+    const char *(*validateUtf8)(const char *, const char *);
+    void (*appendLineStarts)(const char *, const char *, uint32_t, std::vector<uint32_t> &);
+};
+
+Kernels kernelsFor(SimdLevel level) {
+    switch (level) {
+#ifdef PLUMA_SIMD_X86
+        case SimdLevel::AVX2:
+            return Kernels{level, skipBlanksAvx2, skipIdentifierAvx2, findBlockCommentEndAvx2,
+                           findStringSpecialAvx2, validateUtf8Avx2, appendLineStartsAvx2};
+        case SimdLevel::SSE2:
+            return Kernels{level, skipBlanksSse2, skipIdentifierSse2, findBlockCommentEndSse2,
+                           findStringSpecialSse2, validateUtf8Sse2, appendLineStartsSse2};
+#endif
+        default:
+            return Kernels{SimdLevel::SCALAR, skipBlanksScalar, skipIdentifierScalar,
+                           findBlockCommentEndScalar, findStringSpecialScalar,
+                           validateUtf8Scalar, appendLineStartsScalar};
+    }
+}
+
+Kernels &activeKernels() {
+    static Kernels kernels = kernelsFor(maxSimdLevel());
+    return kernels;
+}
+
+}  // namespace
+
+SimdLevel maxSimdLevel() {
+#ifdef PLUMA_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+SimdLevel simdLevel() { return activeKernels().level; }
+
+void setSimdLevel(SimdLevel level) {
+    if ((int)level > (int)maxSimdLevel()) {
+        level = maxSimdLevel();
+    }
+    activeKernels() = kernelsFor(level);
+}
+
+const char *simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+const char *skipBlanks(const char *p, const char *end) {
+    return activeKernels().skipBlanks(p, end);
+}
+
+const char *skipIdentifier(const char *p, const char *end) {
+    return activeKernels().skipIdentifier(p, end);
+}
+
+const char *findBlockCommentEnd(const char *p, const char *end) {
+    return activeKernels().findBlockCommentEnd(p, end);
+}
+
+const char *findStringSpecial(const char *p, const char *end) {
+    return activeKernels().findStringSpecial(p, end);
+}
+
+const char *validateUtf8(const char *p, const char *end) {
+    return activeKernels().validateUtf8(p, end);
+}
+
+void appendLineStarts(const char *p, const char *end, uint32_t base,
+                      std::vector<uint32_t> &starts) {
+    activeKernels().appendLineStarts(p, end, base, starts);
+}
+
+}  // namespace utils
+
+}  // namespace pluma
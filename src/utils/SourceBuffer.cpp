@@ -0,0 +1,112 @@
+#include "utils/SourceBuffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+namespace pluma {
+
+namespace utils {
+
+SourceBuffer::SourceBuffer(std::vector<char> bytes)
+    : bytes(nullptr), length(bytes.size()), owned(std::move(bytes)) {
+    this->bytes = this->owned.data();
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer &&other) noexcept
+    : bytes(other.bytes),
+      length(other.length),
+      mapped(other.mapped),
+      owned(std::move(other.owned)) {
+    if (this->mapped == nullptr) {
+        this->bytes = this->owned.data();
+    }
+    other.bytes = nullptr;
+    other.length = 0;
+    other.mapped = nullptr;
+}
+
+SourceBuffer &SourceBuffer::operator=(SourceBuffer &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (this->mapped != nullptr) {
+        munmap(this->mapped, this->length);
+    }
+    this->length = other.length;
+    this->mapped = other.mapped;
+    this->owned = std::move(other.owned);
+    this->bytes = this->mapped != nullptr ? other.bytes : this->owned.data();
+    other.bytes = nullptr;
+    other.length = 0;
+    other.mapped = nullptr;
+    return *this;
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (this->mapped != nullptr) {
+        munmap(this->mapped, this->length);
+    }
+}
+
+bool SourceBuffer::readAll(int fd) {
+    constexpr size_t readSize = 1 << 16;
+    this->owned.clear();
+    size_t used = 0;
+    while (true) {
+        this->owned.resize(used + readSize);
+        ssize_t n = read(fd, this->owned.data() + used, readSize);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        used += (size_t)n;
+    }
+    this->owned.resize(used);
+    this->bytes = this->owned.data();
+    this->length = used;
+    return true;
+}
+
+bool SourceBuffer::open(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    bool success = false;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            // Every byte is needed: the lexer's chunks are read by several
+            // threads at once, and tokens and the Formatter read back into the
+            // buffer afterwards. Start paging all of it in now.
+            madvise(addr, (size_t)st.st_size, MADV_WILLNEED);
+            this->mapped = addr;
+            this->bytes = (const char *)addr;
+            this->length = (size_t)st.st_size;
+            success = true;
+        }
+    }
+    if (!success) {
+        // Pipes, empty files, or mmap failure.
+        success = this->readAll(fd);
+    }
+
+    close(fd);
+    return success;
+}
+
+}  // namespace utils
+
+}  // namespace pluma
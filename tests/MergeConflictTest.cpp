@@ -0,0 +1,81 @@
+// Grammar::ConstructionStats::mergeConflicts must count the reduce/reduce
+// conflicts LALR(1) merging adds, and only those.
+
+#include <cstdio>
+#include <vector>
+
+#include "Grammar.hpp"
+
+void panic(const char *info) {
+    std::cerr << "\nError: " << info << std::endl;
+    std::abort();
+}
+
+namespace {
+
+using pluma::Grammar;
+using pluma::Nonterminal;
+using pluma::Rule;
+using pluma::SymList;
+using pluma::Terminal;
+using pluma::Token;
+using pluma::TokenType;
+
+Terminal terminal(TokenType type) { return Terminal{Token{"", type}}; }
+
+struct Case {
+    const char *name;
+    std::vector<Rule> rules;
+    size_t lr1Conflicts;
+    size_t lalrConflicts;
+    size_t mergeConflicts;
+};
+
+}  // namespace
+
+int main() {
+    Terminal a = terminal(TokenType::ADD), b = terminal(TokenType::SUB),
+             c = terminal(TokenType::MUL), d = terminal(TokenType::DIV),
+             e = terminal(TokenType::MOD), g = terminal(TokenType::BITAND);
+    Nonterminal start{"start"}, S{"S"}, X{"X"}, Y{"Y"};
+
+    std::vector<Case> cases{
+        // S -> a X c | a Y d | b X d | b Y c, X -> e, Y -> e: merging the
+        // states after `a e` and `b e` makes X and Y reduce on both c and d.
+        {"merged state",
+         {start >> SymList{S}, S >> SymList{a, X, c}, S >> SymList{a, Y, d},
+          S >> SymList{b, X, d}, S >> SymList{b, Y, c}, X >> SymList{e}, Y >> SymList{e}},
+         0, 2, 2},
+        // The same with X -> e g and Y -> e g: the conflict shows up in the
+        // successor of the merged state, after `e g`.
+        {"successor of a merged state",
+         {start >> SymList{S}, S >> SymList{a, X, c}, S >> SymList{a, Y, d},
+          S >> SymList{b, X, d}, S >> SymList{b, Y, c}, X >> SymList{e, g},
+          Y >> SymList{e, g}},
+         0, 2, 2},
+        // S -> a X c | a Y c | b X d | b Y d: canonical LR(1) already
+        // conflicts, so merging adds nothing.
+        {"canonical conflict",
+         {start >> SymList{S}, S >> SymList{a, X, c}, S >> SymList{a, Y, c},
+          S >> SymList{b, X, d}, S >> SymList{b, Y, d}, X >> SymList{e}, Y >> SymList{e}},
+         2, 2, 0},
+    };
+
+    bool ok = true;
+    for (const Case &test : cases) {
+        Grammar lr1("", test.rules, Grammar::Construction::LR1);
+        Grammar lalr("", test.rules, Grammar::Construction::LALR1);
+        const Grammar::ConstructionStats &lr1Stats = lr1.constructionStats();
+        const Grammar::ConstructionStats &lalrStats = lalr.constructionStats();
+        if (lr1Stats.conflicts != test.lr1Conflicts || lalrStats.conflicts != test.lalrConflicts ||
+            lalrStats.mergeConflicts != test.mergeConflicts) {
+            fprintf(stderr,
+                    "%s: LR(1) %zu conflicts, LALR(1) %zu conflicts, %zu from merging; "
+                    "expected %zu, %zu, %zu\n",
+                    test.name, lr1Stats.conflicts, lalrStats.conflicts, lalrStats.mergeConflicts,
+                    test.lr1Conflicts, test.lalrConflicts, test.mergeConflicts);
+            ok = false;
+        }
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
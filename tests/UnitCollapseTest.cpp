@@ -0,0 +1,69 @@
+// The Formatter must write the same output for a tree built with unit
+// collapsing as for the plain one.
+//
+//     unit_collapse_test <input.c>...
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Formatter.h"
+#include "Lexer.h"
+#include "c/CParser.h"
+
+void panic(const char *info) {
+    std::cerr << "\nError: " << info << std::endl;
+    std::abort();
+}
+
+namespace {
+
+std::string slurp(const std::string &filename) {
+    std::ifstream in(filename);
+    std::stringstream bytes;
+    bytes << in.rdbuf();
+    return bytes.str();
+}
+
+// Formats `tokens` into `output`; false if they do not parse.
+bool formatTo(pluma::Grammar &grammar, const pluma::TokenStream &tokens,
+              const std::string &output) {
+    pluma::Ast ast = grammar.gen(tokens);
+    if (ast.head == nullptr) {
+        return false;
+    }
+    pluma::Formatter formatter(output);
+    formatter.format(ast, tokens, grammar.rules());
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    pluma::CParser parser;
+    pluma::Grammar &grammar = *parser.grammarPtr;
+    bool ok = argc > 1;
+    for (int i = 1; i < argc; ++i) {
+        pluma::Lexer lexer(argv[i]);
+        pluma::TokenStream tokens = lexer.tokenize();
+
+        grammar.setUnitCollapsing(false);
+        bool plainParsed = formatTo(grammar, tokens, "plain.out");
+        grammar.setUnitCollapsing(true);
+        bool collapsedParsed = formatTo(grammar, tokens, "collapsed.out");
+        size_t collapses = grammar.lastParseStats().unitCollapses;
+
+        if (!plainParsed || !collapsedParsed) {
+            fprintf(stderr, "%s: does not parse\n", argv[i]);
+            ok = false;
+        } else if (collapses == 0) {
+            fprintf(stderr, "%s: nothing was collapsed\n", argv[i]);
+            ok = false;
+        } else if (slurp("plain.out") != slurp("collapsed.out")) {
+            fprintf(stderr, "%s: formatted differently with unit collapsing\n", argv[i]);
+            ok = false;
+        }
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,23 @@
+// One-item enum and initializer lists, storage classes and qualifiers, and
+// braced and unbraced statement bodies: the places the Formatter looks through
+// nodes that unit collapsing removes.
+#include <stdio.h>
+enum color { RED };
+enum shade { DARK, LIGHT = 2, PALE };
+static const int table[3] = { 1 };
+int grid[2] = { 1, 2, 3 };
+static int counter;
+const char *name;
+struct point { int x, y; };
+int f(int a, int b);
+int main(int argc, char *argv[]) {
+    int i = 0;
+    if (i) i = 1;
+    if (i) { i = 2; } else i = 3;
+    if (i) i = 4; else { i = 5; }
+    while (i) i--;
+    for (i = 0; i < 10; i++) { i = i * 2 + 1; }
+    for (i = 0; i < 10; i++) i += f(i, a ? b : c);
+    do i++; while (i < 3);
+    return (i);
+}